@@ -0,0 +1,89 @@
+#include "framework.hpp"
+#include "lockfree/Queue.hpp"
+#include "lockfree/MpscQueue.hpp"
+#include "constants.hpp"
+
+using namespace NativeJS;
+
+/**
+ * @brief Push/pop throughput of the event queue channels: the bounded MPMC ring against the unbounded MPSC list.
+ * Every run has a single consumer, as the worker and main thread inboxes do, and a varying number of producers.
+ * Usage: queue-bench [items per producer]
+ */
+
+template<typename Queue>
+static double run(Queue& queue, const size_t producers, const size_t items)
+{
+	using Clock = std::chrono::steady_clock;
+
+	std::atomic<bool> isStarted = false;
+	std::vector<std::thread> threads;
+
+	for (size_t p = 0; p < producers; p++)
+	{
+		threads.emplace_back([&]()
+		{
+			while (!isStarted.load(std::memory_order::acquire))
+				std::this_thread::yield();
+
+			for (size_t i = 1; i <= items; i++)
+			{
+				// a full ring makes the producer retry, as a caller with a spill list would fall back to it
+				while (!queue.push(i))
+					std::this_thread::yield();
+			}
+		});
+	}
+
+	const Clock::time_point start = Clock::now();
+	isStarted.store(true, std::memory_order::release);
+
+	size_t value = 0;
+	size_t popped = 0;
+	size_t sum = 0;
+	while (popped < producers * items)
+	{
+		if (queue.pop(value))
+		{
+			sum += value;
+			popped++;
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+	for (std::thread& thread : threads)
+		thread.join();
+
+	if (sum != producers * items * (items + 1) / 2)
+	{
+		fprintf(stderr, "Lost items!\n");
+		exit(1);
+	}
+
+	return static_cast<double>(popped) / seconds / 1e6;
+}
+
+int main(int argc, char** argv)
+{
+	const size_t items = argc > 1 ? std::stoull(argv[1]) : 1000000;
+
+	printf("%u hardware threads, %zu items per producer\n", std::thread::hardware_concurrency(), items);
+	printf("%-10s %12s %12s\n", "producers", "MPMC Mops/s", "MPSC Mops/s");
+
+	for (const size_t producers : { 1, 2, 4, 8 })
+	{
+		LockFree::Queue<size_t> mpmc(MAX_QUEUE_SIZE);
+		LockFree::MpscQueue<size_t> mpsc(MAX_QUEUE_SIZE);
+
+		const double mpmcRate = run(mpmc, producers, items);
+		const double mpscRate = run(mpsc, producers, items);
+		printf("%-10zu %12.2f %12.2f\n", producers, mpmcRate, mpscRate);
+	}
+
+	return 0;
+}
@@ -9,11 +9,16 @@
 #include "AppConfig.hpp"
 #include "lockfree/Queue.hpp"
 #include "WindowManager.hpp"
+#include "AsyncWorkerPool.hpp"
+#include "EventSubscriptions.hpp"
+#include "ArrayBufferPool.hpp"
+#include "js/Snapshot.hpp"
+#include "CodeCache.hpp"
+#include "ModuleResolver.hpp"
+#include "ModuleSources.hpp"
 
 namespace NativeJS
 {
-	class AsyncWorker;
-
 	class App
 	{
 	private:
@@ -21,7 +26,6 @@ namespace NativeJS
 
 #ifdef _WINDOWS
 		static LRESULT CALLBACK windowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
-		static void CALLBACK timerProc(HWND, UINT, UINT_PTR, DWORD);
 #endif
 
 	public:
@@ -34,17 +38,23 @@ namespace NativeJS
 		static int terminate();
 
 	private:
-		App(int argc, char** argv, std::filesystem::path&& rootDir, const size_t maxAsyncWorkers, const size_t maxV8PlatformThreads, const size_t tickTimeout);
+		App(int argc, char** argv, std::filesystem::path&& rootDir, const size_t maxAsyncWorkers, const size_t maxV8PlatformThreads, const size_t tickTimeout, std::filesystem::path&& snapshotOutput);
 		App(const App&) = delete;
 		App(App&&) = delete;
 
 	public:
 		~App();
 
+		/**
+		 * @brief Runs the entry worker until the app quits, or only writes the startup snapshot when BUILD_SNAPSHOT was passed.
+		 */
 		void run();
 
-		Worker* createWorker(const std::filesystem::path& entry, Worker* parentWorker = nullptr);
-		Worker* createWorker(std::filesystem::path&& entry, Worker* parentWorker = nullptr);
+		/**
+		 * @param heapLimits the heap sizing of the worker, the heap settings of app.json when nullptr
+		 */
+		Worker* createWorker(const std::filesystem::path& entry, Worker* parentWorker = nullptr, const HeapLimits* heapLimits = nullptr);
+		Worker* createWorker(std::filesystem::path&& entry, Worker* parentWorker = nullptr, const HeapLimits* heapLimits = nullptr);
 		bool destroyWorker(Worker* worker);
 
 		std::vector<const char*> getAppArgs() const;
@@ -53,12 +63,36 @@ namespace NativeJS
 		const std::filesystem::path& rootDir() const;
 		const AppConfig& appConfig() const;
 		WindowManager& windowManager();
+		ArrayBufferPool& arrayBufferPool();
+		JS::Snapshot& snapshot();
+		CodeCache& codeCache();
+		CodeCache& jsonCache();
+		ModuleResolver& moduleResolver();
+		ModuleSources& moduleSources();
+
+		/**
+		 * @brief Subscriptions to the native messages that are not bound to a window (e.g. WM_QUIT).
+		 */
+		EventSubscriptions& subscriptions();
 
-		bool getAsyncWork(Event*& event);
 		bool postEvent(Event* event, bool onMainThread = false);
 
 	private:
 		void emitEvent(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
+		void processEvent(Event* event, bool& isRunning);
+
+		/**
+		 * @returns a standby worker with the given heap limits, or nullptr if the pool has none
+		 */
+		Worker* takeStandbyWorker(const HeapLimits& heapLimits);
+		/**
+		 * @brief Tops the pool up to appConfig().workerPool, the new workers build their env on their own threads.
+		 */
+		void refillWorkerPool();
+
+#ifdef __linux__
+		void wakeMainThread();
+#endif
 
 #ifdef _WINDOWS
 		using ThreadID = DWORD;
@@ -72,13 +106,20 @@ namespace NativeJS
 		std::filesystem::path rootDir_;
 		Logger& logger_;
 		int exitCode_;
-		std::vector<AsyncWorker*> asyncWorkers_;
-		LockFree::Queue<Event*> asyncEventQueue_;
-		std::mutex asyncMutex_;
-		std::condition_variable asyncCV_;
+		const size_t maxAsyncWorkers_;
+		AsyncWorkerPool asyncWorkers_;
+		ArrayBufferPool arrayBuffers_;
+		JS::Snapshot snapshot_;
+		std::filesystem::path snapshotOutput_;
+		CodeCache codeCache_;
+		CodeCache jsonCache_;
+		ModuleResolver moduleResolver_;
+		ModuleSources moduleSources_;
 
 		PersistentList<Worker> workers_;
 		Worker* mainWorker_;
+		std::vector<Worker*> standbyWorkers_;
+		bool isWorkerPoolActive_;
 
 		EventQueue eventQueue_;
 		EventAllocator events_;
@@ -87,14 +128,19 @@ namespace NativeJS
 
 		AppConfig appConfig_;
 		WindowManager windowManager_;
-
-		std::unordered_map<UINT_PTR, TimeoutEvent*> timeoutEvents_;
-		std::unordered_map<size_t, UINT_PTR> timeoutIDsToPtrs_;
+		EventSubscriptions subscriptions_;
+		std::vector<Worker*> subscribers_;
+		std::vector<NativeEvent*> coalescing_;
 
 		bool isTerminating_;
 
 #ifdef _WINDOWS
 		WNDCLASS wc_;
+#elif defined(__linux__)
+		int epollFd_;
+		int wakeFd_;
+		int signalFd_;
+		std::atomic<bool> isWakePending_;
 #endif
 	};
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "framework.hpp"
+#include "HeapLimits.hpp"
 
 namespace NativeJS
 {
@@ -14,12 +15,44 @@ namespace NativeJS
 		struct Entry {
 			std::string file;
 			std::string exportName = "default";
+			/**
+			 * @brief The heap settings of the main worker, the app-wide ones overridden by entry.heap.
+			 */
+			HeapLimits heap;
 		};
 
 		std::string name;
 		std::string type;
 		Entry entry;
 		std::vector<std::string> resolve;
+		/**
+		 * @brief Keep the module resolution cache up to date with file changes in the app directory, only supported on Linux.
+		 */
+		bool watchModules = false;
+		/**
+		 * @brief The heap settings of every worker that does not pass its own.
+		 */
+		HeapLimits heap;
+		/**
+		 * @brief Back large ArrayBuffers with huge pages where the OS allows it.
+		 */
+		bool hugePages = false;
+		/**
+		 * @brief Number of standby workers with a ready env that new Workers are taken from, the pool is only filled once the app spawned a Worker.
+		 */
+		size_t workerPool = 1;
+		/**
+		 * @brief Path of the startup snapshot relative to the app, written by running with BUILD_SNAPSHOT=<path>.
+		 */
+		std::string snapshot;
+		/**
+		 * @brief Directory of the module code cache relative to the app, "codeCache": false disables it.
+		 */
+		std::string codeCache = ".native-js/code-cache";
+		/**
+		 * @brief Directory to persist the serialized JSON modules in, relative to the app. Unset by default, which keeps them in memory only.
+		 */
+		std::string jsonCache;
 		
 		AppConfig() {};
 
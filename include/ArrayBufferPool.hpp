@@ -0,0 +1,75 @@
+#pragma once
+
+#include "framework.hpp"
+#include "constants.hpp"
+
+namespace NativeJS
+{
+	/**
+	 * @brief App-wide backing memory for ArrayBuffers, shared by the allocators of all isolates.
+	 * Small buffers are rounded up to a power-of-two size class. Every class owns a reserved range of address space
+	 * that is handed out front to back, so a block that was never used is still a zero page from the OS and needs no clearing.
+	 * Freed blocks go onto a lock-free free list threaded through the blocks themselves and are only cleared when a zeroed buffer reuses them.
+	 * Buffers above the largest class, or whose class ran out of address space, are mapped directly and can be backed by huge pages.
+	 */
+	class ArrayBufferPool
+	{
+	public:
+		ArrayBufferPool();
+		ArrayBufferPool(const ArrayBufferPool&) = delete;
+		ArrayBufferPool(ArrayBufferPool&&) = delete;
+		~ArrayBufferPool();
+
+		/**
+		 * @param zeroed whether the first length bytes have to be zero
+		 * @returns nullptr if the memory could not be allocated
+		 */
+		void* alloc(size_t length, bool zeroed);
+		void free(void* data, size_t length);
+
+		/**
+		 * @brief Backs direct mappings of at least HUGE_PAGE_SIZE with huge pages where the OS allows it.
+		 */
+		inline void setHugePages(bool useHugePages) { useHugePages_.store(useHugePages, std::memory_order::relaxed); }
+
+		/**
+		 * @returns the number of bytes held by the size classes, in use or waiting to be reused
+		 */
+		size_t pooledBytes() const;
+
+	private:
+		static constexpr size_t CLASS_COUNT = ARRAY_BUFFER_MAX_CLASS_SHIFT - ARRAY_BUFFER_MIN_CLASS_SHIFT + 1;
+
+		struct SizeClass
+		{
+			SizeClass(size_t blockSize);
+			~SizeClass();
+
+			inline bool owns(const void* data) const { return data >= base && data < base + blockSize * capacity; }
+			inline char* block(uint32_t index) const { return base + blockSize * index; }
+
+			void* pop();
+			void push(void* data);
+
+			const size_t blockSize;
+			const size_t capacity;
+			char* base;
+			std::atomic<size_t> carved;
+			/**
+			 * @brief ABA tag in the high half, index + 1 of the first free block in the low half
+			 */
+			std::atomic<uint64_t> freeList;
+		};
+
+		/**
+		 * @returns CLASS_COUNT if the length is larger than the largest class
+		 */
+		static size_t classOf(size_t length);
+
+		void* mapPages(size_t length);
+		void unmapPages(void* data, size_t length);
+
+		SizeClass* classes_[CLASS_COUNT];
+		std::atomic<bool> useHugePages_;
+	};
+}
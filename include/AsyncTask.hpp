@@ -0,0 +1,123 @@
+#pragma once
+
+#include "framework.hpp"
+#include "constants.hpp"
+
+namespace NativeJS
+{
+	class Worker;
+	class WorkEvent;
+
+	/**
+	 * @brief Type-erased work and resolve callables of an async event.
+	 * work(Worker&) runs on the async (or main) thread and its result is handed to resolve(const WorkEvent&, Result&&)
+	 * on the thread of the worker, a void work calls resolve(const WorkEvent&).
+	 * Both callables and the result are stored inline when they fit in ASYNC_TASK_INLINE_SIZE bytes, so captured state needs no allocation.
+	 */
+	class AsyncTask
+	{
+	public:
+		AsyncTask() :
+			target_(nullptr),
+			ops_(nullptr)
+		{ }
+
+		AsyncTask(const AsyncTask&) = delete;
+		AsyncTask(AsyncTask&&) = delete;
+
+		~AsyncTask() { reset(); }
+
+		template<typename Work, typename Resolve>
+		void emplace(Work&& work, Resolve&& resolve)
+		{
+			using Task = Holder<std::decay_t<Work>, std::decay_t<Resolve>>;
+
+			reset();
+
+			if constexpr (sizeof(Task) <= sizeof(storage_) && alignof(Task) <= alignof(std::max_align_t))
+				target_ = std::construct_at(reinterpret_cast<Task*>(storage_), std::forward<Work>(work), std::forward<Resolve>(resolve));
+			else
+				target_ = new Task(std::forward<Work>(work), std::forward<Resolve>(resolve));
+
+			ops_ = &Task::ops;
+		}
+
+		inline bool empty() const { return ops_ == nullptr; }
+
+		inline void run(Worker& worker) { ops_->run(target_, worker); }
+
+		/**
+		 * @brief Calls resolve and destroys the callables, so captured handles are released on the thread of the worker.
+		 */
+		void resolve(const WorkEvent& event)
+		{
+			ops_->resolve(target_, event);
+			reset();
+		}
+
+		void reset()
+		{
+			if (ops_ == nullptr)
+				return;
+			ops_->destroy(target_, target_ != storage_);
+			target_ = nullptr;
+			ops_ = nullptr;
+		}
+
+	private:
+		struct Ops
+		{
+			void (*run)(void* target, Worker& worker);
+			void (*resolve)(void* target, const WorkEvent& event);
+			void (*destroy)(void* target, bool isHeap);
+		};
+
+		template<typename Work, typename Resolve>
+		struct Holder
+		{
+			using Result = std::invoke_result_t<Work&, Worker&>;
+			using Storage = std::conditional_t<std::is_void_v<Result>, std::monostate, std::optional<Result>>;
+
+			template<typename W, typename R>
+			Holder(W&& work, R&& resolve) :
+				work(std::forward<W>(work)),
+				resolve(std::forward<R>(resolve)),
+				result()
+			{ }
+
+			Work work;
+			Resolve resolve;
+			Storage result;
+
+			static constexpr Ops ops = {
+				[](void* target, Worker& worker)
+				{
+					Holder& task = *static_cast<Holder*>(target);
+					if constexpr (std::is_void_v<Result>)
+						task.work(worker);
+					else
+						task.result.emplace(task.work(worker));
+				},
+				[](void* target, const WorkEvent& event)
+				{
+					Holder& task = *static_cast<Holder*>(target);
+					if constexpr (std::is_void_v<Result>)
+						task.resolve(event);
+					else
+						task.resolve(event, std::move(*task.result));
+				},
+				[](void* target, bool isHeap)
+				{
+					if (isHeap)
+						delete static_cast<Holder*>(target);
+					else
+						std::destroy_at(static_cast<Holder*>(target));
+				}
+			};
+		};
+
+		void* target_;
+		const Ops* ops_;
+		alignas(std::max_align_t) unsigned char storage_[ASYNC_TASK_INLINE_SIZE];
+	};
+}
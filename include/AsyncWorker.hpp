@@ -1,32 +1,34 @@
 #pragma once
 
 #include "framework.hpp"
+#include "lockfree/Queue.hpp"
 
 namespace NativeJS
 {
-	class App;
 	class Event;
-	class EventQueue;
+	class AsyncWorkerPool;
 
 	class AsyncWorker
 	{
 	public:
-		AsyncWorker(App& app);
+		AsyncWorker(AsyncWorkerPool& pool, size_t index);
 		AsyncWorker(const AsyncWorker&) = delete;
 		AsyncWorker(AsyncWorker&&) = delete;
 		~AsyncWorker();
 
-		void terminate();
-		
 	protected:
 		int entry();
 
 	private:
-		App& app_;
+		AsyncWorkerPool& pool_;
+		const size_t index_;
+		LockFree::Queue<Event*> queue_;
 		std::mutex mutex_;
 		std::condition_variable cv_;
-		std::thread thread_;
 		size_t returnCode_;
 		std::atomic<bool> isRunning_;
+		std::thread thread_;
+
+		friend class AsyncWorkerPool;
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "framework.hpp"
+#include "Futex.hpp"
+
+namespace NativeJS
+{
+	class App;
+	class Event;
+	class AsyncWorker;
+
+	/**
+	 * @brief Pool of AsyncWorkers that each own a queue of work.
+	 * Work submitted by a JS worker lands on the queue of its home AsyncWorker, idle AsyncWorkers steal from the others.
+	 */
+	class AsyncWorkerPool
+	{
+	public:
+		AsyncWorkerPool(App& app);
+		AsyncWorkerPool(const AsyncWorkerPool&) = delete;
+		AsyncWorkerPool(AsyncWorkerPool&&) = delete;
+		~AsyncWorkerPool();
+
+		void init(size_t size);
+
+		/**
+		 * @brief Signals all the AsyncWorkers to stop and waits for them to exit, work that is still queued is dropped.
+		 */
+		void terminate();
+
+		/**
+		 * @brief Queues the event on the AsyncWorker picked by affinity, or on any other AsyncWorker if that one is full.
+		 * If all the queues are full the event goes to an unbounded overflow list, which the AsyncWorkers read once their queues ran dry.
+		 * @returns false if the pool is not running
+		 */
+		bool submit(Event* event, size_t affinity);
+
+		inline size_t size() const { return size_.load(std::memory_order::acquire); }
+
+	private:
+		/**
+		 * @brief Pops from the queue of the given AsyncWorker, steals from the others or parks until there is work.
+		 * @returns false when the pool is terminating
+		 */
+		bool getWork(AsyncWorker& worker, Event*& event);
+		bool tryGetWork(AsyncWorker& worker, Event*& event);
+
+		App& app_;
+		std::vector<AsyncWorker*> workers_;
+		std::atomic<size_t> size_;
+		std::mutex overflowMutex_;
+		std::deque<Event*> overflow_;
+		std::atomic<size_t> overflowSize_;
+		Futex signal_;
+		std::atomic<uint32_t> sleepers_;
+		std::atomic<bool> isTerminating_;
+
+		friend class AsyncWorker;
+	};
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "framework.hpp"
+#include "Hasher.hpp"
+
+namespace NativeJS
+{
+	/**
+	 * @brief App-wide store of data V8 produced from a source, e.g. the code caches of ES modules or the serialized values of JSON modules,
+	 * shared by all workers and optionally persisted in a directory beside the app.
+	 * Entries are keyed by the hash of the source, the files also carry the cached data version tag of V8,
+	 * which covers its version and flags, so a cache of another V8 build is never even read.
+	 */
+	class CodeCache
+	{
+	public:
+		using Data = std::shared_ptr<const std::vector<uint8_t>>;
+
+		/**
+		 * @param extension of the files, tells the kinds of data apart if several caches share a directory
+		 */
+		CodeCache(const char* extension = ".jsc");
+		CodeCache(const CodeCache&) = delete;
+		CodeCache(CodeCache&&) = delete;
+
+		/**
+		 * @brief Enables the cache, must be called once V8 is initialized. An empty directory keeps the entries in memory only.
+		 */
+		void setDirectory(const std::filesystem::path& directory);
+
+		inline bool isEnabled() const { return isEnabled_; }
+
+		/**
+		 * @returns the cached data of the source with the given hash, or nullptr if there is none yet
+		 */
+		Data get(Hash sourceHash);
+
+		/**
+		 * @brief Replaces the cached data of the source, e.g. after V8 rejected the previous one, and writes it to disk.
+		 * @returns the stored data, nullptr if the cache is disabled
+		 */
+		Data put(Hash sourceHash, std::vector<uint8_t>&& data);
+
+	private:
+		std::filesystem::path pathOf(Hash sourceHash) const;
+
+		const std::string extension_;
+		std::filesystem::path directory_;
+		bool isEnabled_;
+		uint32_t versionTag_;
+		std::mutex mutex_;
+		// a null entry records a miss, so the other workers do not look for the file again
+		std::unordered_map<Hash, Data> entries_;
+	};
+}
@@ -0,0 +1,287 @@
+#pragma once
+
+#include "framework.hpp"
+#include "lockfree/Stack.hpp"
+
+namespace NativeJS
+{
+	/**
+	 * @brief Thread-safe counterpart of StackAllocator.
+	 * Every thread keeps two batches of free slots for the allocator, full and empty batches are exchanged
+	 * with a shared depot built on LockFree::Stack, so allocating on one thread and freeing on another never takes a lock.
+	 * When the depot runs dry a new chunk of ChunkSize slots is added instead of failing, when it is full it adds another shelf of stacks.
+	 * Slots are only given back to the system when the allocator and every thread that cached slots of it are gone.
+	 */
+	template<typename T, size_t ChunkSize = 256, size_t BatchSize = 32>
+	class ConcurrentStackAllocator
+	{
+		static_assert(ChunkSize % BatchSize == 0, "ChunkSize has to be a multiple of BatchSize!");
+
+		using Ptr = T*;
+
+		struct Batch
+		{
+			size_t count = 0;
+			Ptr items[BatchSize];
+		};
+
+		struct Chunk
+		{
+			Chunk* next;
+			alignas(T) unsigned char storage[sizeof(T) * ChunkSize];
+		};
+
+		struct Shelf
+		{
+			Shelf(size_t capacity, Shelf* next) :
+				full(capacity),
+				empty(capacity),
+				capacity(capacity),
+				next(next)
+			{ }
+
+			LockFree::Stack<Batch*> full;
+			LockFree::Stack<Batch*> empty;
+			const size_t capacity;
+			Shelf* next;
+		};
+
+		struct Depot
+		{
+			Depot(size_t capacity) :
+				shelves(new Shelf(capacity, nullptr)),
+				chunks(nullptr),
+				isReleased(false)
+			{ }
+
+			~Depot()
+			{
+				Shelf* shelf = shelves.load(std::memory_order::acquire);
+				while (shelf != nullptr)
+				{
+					Batch* batch;
+					while (shelf->full.pop(batch))
+						delete batch;
+					while (shelf->empty.pop(batch))
+						delete batch;
+
+					Shelf* next = shelf->next;
+					delete shelf;
+					shelf = next;
+				}
+
+				Chunk* chunk = chunks.load(std::memory_order::acquire);
+				while (chunk != nullptr)
+				{
+					Chunk* next = chunk->next;
+					delete chunk;
+					chunk = next;
+				}
+			}
+
+			// shelves are only ever added, so walking them needs no protection
+			std::atomic<Shelf*> shelves;
+			std::atomic<Chunk*> chunks;
+			// set once the allocator is destroyed, the threads then drop their caches of it
+			std::atomic<bool> isReleased;
+		};
+
+		struct Cache
+		{
+			std::shared_ptr<Depot> depot;
+			Batch* loaded;
+			Batch* previous;
+		};
+
+		/**
+		 * @brief The caches of the calling thread, handed back to their depots when the thread exits.
+		 */
+		struct ThreadCaches
+		{
+			~ThreadCaches()
+			{
+				for (Cache& cache : caches)
+					dropCache(cache);
+			}
+
+			std::vector<Cache> caches;
+		};
+
+	public:
+		/**
+		 * @param depotCapacity the number of batches the shared depot holds before it adds a shelf, every shelf doubles it
+		 */
+		ConcurrentStackAllocator(size_t depotCapacity = 1024) :
+			depot_(std::make_shared<Depot>(depotCapacity))
+		{ }
+
+		ConcurrentStackAllocator(const ConcurrentStackAllocator& other) = delete;
+		ConcurrentStackAllocator(ConcurrentStackAllocator&& other) = delete;
+
+		// the depot stays alive until the last thread that cached slots of it dropped them
+		~ConcurrentStackAllocator()
+		{
+			depot_->isReleased.store(true, std::memory_order::release);
+		}
+
+		template<class... Args>
+			requires std::constructible_from<T, Args...>
+		T* alloc(Args&&... args)
+		{
+			Cache& c = cache();
+
+			if (c.loaded->count == 0)
+			{
+				Batch* full;
+				if (c.previous->count > 0)
+				{
+					std::swap(c.loaded, c.previous);
+				}
+				else if (popFullBatch(*depot_, full))
+				{
+					pushBatch(*depot_, c.loaded);
+					c.loaded = full;
+				}
+				else
+				{
+					grow(*c.loaded);
+				}
+			}
+
+			return std::construct_at(c.loaded->items[--c.loaded->count], std::forward<Args>(args)...);
+		}
+
+		void free(T*& ptr)
+		{
+			std::destroy_at(ptr);
+
+			Cache& c = cache();
+
+			if (c.loaded->count == BatchSize)
+			{
+				if (c.previous->count == 0)
+				{
+					std::swap(c.loaded, c.previous);
+				}
+				else
+				{
+					pushBatch(*depot_, c.previous);
+					c.previous = c.loaded;
+					c.loaded = popEmptyBatch(*depot_);
+				}
+			}
+
+			c.loaded->items[c.loaded->count++] = ptr;
+			ptr = nullptr;
+		}
+
+	private:
+		static ThreadCaches& threadCaches()
+		{
+			thread_local ThreadCaches caches;
+			return caches;
+		}
+
+		Cache& cache()
+		{
+			std::vector<Cache>& caches = threadCaches().caches;
+			for (Cache& c : caches)
+				if (c.depot.get() == depot_.get())
+					return c;
+
+			// the caches of destroyed allocators are only dropped here, so a thread that keeps using the same allocators never scans twice
+			std::erase_if(caches, [](Cache& c)
+			{
+				if (!c.depot->isReleased.load(std::memory_order::acquire))
+					return false;
+				dropCache(c);
+				return true;
+			});
+
+			return caches.emplace_back(Cache { depot_, popEmptyBatch(*depot_), popEmptyBatch(*depot_) });
+		}
+
+		/**
+		 * @brief Adds a chunk, one batch of it goes to into and the rest to the depot.
+		 */
+		void grow(Batch& into)
+		{
+			Chunk* chunk = new Chunk();
+			chunk->next = depot_->chunks.load(std::memory_order::relaxed);
+			while (!depot_->chunks.compare_exchange_weak(chunk->next, chunk, std::memory_order::release, std::memory_order::relaxed));
+
+			Ptr items = reinterpret_cast<Ptr>(chunk->storage);
+
+			for (size_t i = 0; i < BatchSize; i++)
+				into.items[i] = &items[i];
+			into.count = BatchSize;
+
+			for (size_t offset = BatchSize; offset < ChunkSize; offset += BatchSize)
+			{
+				Batch* batch = popEmptyBatch(*depot_);
+				for (size_t i = 0; i < BatchSize; i++)
+					batch->items[i] = &items[offset + i];
+				batch->count = BatchSize;
+				pushBatch(*depot_, batch);
+			}
+		}
+
+		static void dropCache(Cache& cache)
+		{
+			// the batches of a released depot only point into its chunks, which go away with it
+			if (cache.depot->isReleased.load(std::memory_order::acquire))
+			{
+				delete cache.loaded;
+				delete cache.previous;
+				return;
+			}
+
+			pushBatch(*cache.depot, cache.loaded);
+			pushBatch(*cache.depot, cache.previous);
+		}
+
+		static bool popFullBatch(Depot& depot, Batch*& batch)
+		{
+			for (Shelf* shelf = depot.shelves.load(std::memory_order::acquire); shelf != nullptr; shelf = shelf->next)
+				if (shelf->full.pop(batch))
+					return true;
+			return false;
+		}
+
+		static Batch* popEmptyBatch(Depot& depot)
+		{
+			Batch* batch;
+			for (Shelf* shelf = depot.shelves.load(std::memory_order::acquire); shelf != nullptr; shelf = shelf->next)
+				if (shelf->empty.pop(batch))
+					return batch;
+			return new Batch();
+		}
+
+		/**
+		 * @brief Hands a batch back to the depot. A batch with slots is never dropped, if every shelf is full a new one takes it,
+		 * an empty batch that does not fit is simply deleted.
+		 */
+		static void pushBatch(Depot& depot, Batch* batch)
+		{
+			const bool isFull = batch->count > 0;
+
+			for (Shelf* shelf = depot.shelves.load(std::memory_order::acquire); shelf != nullptr; shelf = shelf->next)
+				if (isFull ? shelf->full.push(batch) : shelf->empty.push(batch))
+					return;
+
+			if (!isFull)
+			{
+				delete batch;
+				return;
+			}
+
+			// doubling keeps the number of shelves a push or pop walks logarithmic
+			Shelf* head = depot.shelves.load(std::memory_order::relaxed);
+			Shelf* shelf = new Shelf(head->capacity * 2, head);
+			shelf->full.push(batch);
+			while (!depot.shelves.compare_exchange_weak(shelf->next, shelf, std::memory_order::release, std::memory_order::relaxed));
+		}
+
+		std::shared_ptr<Depot> depot_;
+	};
+}
@@ -2,6 +2,7 @@
 
 #include "framework.hpp"
 #include "StrongAtomic.hpp"
+#include "AsyncTask.hpp"
 
 #define WORK_EVENT_CLASS(__NAME__, __EVENT_TYPE__) class __NAME__ : public WorkEvent \
 { \
@@ -15,6 +16,7 @@ public: \
 namespace NativeJS
 {
 	class Worker;
+	class EventAllocator;
 
 	namespace JS
 	{
@@ -31,7 +33,6 @@ namespace NativeJS
 			Native,
 			Blocking,
 			Message,
-			Timeout,
 			Terminate
 		};
 
@@ -70,9 +71,14 @@ namespace NativeJS
 	protected:
 		const Type type_;
 		StrongAtomic<Status> status_;
-		size_t index_;
 		void* data_;
 
+	private:
+		EventAllocator* allocator_;
+		Event* prevLive_;
+		Event* nextLive_;
+		Event* nextRemoved_;
+
 		friend class EventAllocator;
 	};
 
@@ -91,13 +97,31 @@ namespace NativeJS
 		Worker& worker() const { return worker_; }
 		inline void resolve() const { resolver_(*this); }
 		void resolvePromise(v8::Local<v8::Value> val = v8::Local<v8::Value>()) const;
+		void rejectPromise(v8::Local<v8::Value> reason) const;
 		v8::Local<v8::Promise> promise() const;
 
+		/**
+		 * @brief Replaces the work and resolver callbacks with callables that keep their state inside the event.
+		 * @see AsyncTask
+		 */
+		template<typename Work, typename Resolve>
+		void emplaceTask(Work&& work, Resolve&& resolve)
+		{
+			task_.emplace(std::forward<Work>(work), std::forward<Resolve>(resolve));
+			work_ = [](Event* event)
+			{
+				WorkEvent& e = event->as<WorkEvent>();
+				e.task_.run(e.worker_);
+			};
+			resolver_ = [](const WorkEvent& e) { e.task_.resolve(e); };
+		}
+
 	private:
 		Worker& worker_;
 		WorkCallback work_;
 		ResolverCallback resolver_;
 		v8::Persistent<v8::Promise::Resolver> promiseResolver_;
+		mutable AsyncTask task_;
 
 		friend class AsyncWorker;
 		friend class App;
@@ -137,6 +161,7 @@ namespace NativeJS
 		inline const std::string& message() const { return message_; }
 		v8::Local<v8::Promise> promise() const;
 		void resolvePromise() const;
+		void rejectPromise(v8::Local<v8::Value> reason) const;
 
 	private:
 		Worker* sender_;
@@ -145,7 +170,6 @@ namespace NativeJS
 		v8::Persistent<v8::Promise::Resolver> promiseResolver_;
 	};
 
-#ifdef _WINDOWS
 	struct OSEvent
 	{
 		HWND hwnd;
@@ -153,22 +177,44 @@ namespace NativeJS
 		WPARAM wParam;
 		LPARAM lParam;
 	};
-#endif
 
 	class NativeEvent : public Event
 	{
 	public:
+		/**
+		 * @returns true for the high-rate messages (mouse moves, resizes and scrolls) that are merged while pending
+		 */
+		static bool isCoalescable(UINT uMsg);
+
 		NativeEvent(const OSEvent& osEvent, size_t sendCount);
 		virtual ~NativeEvent();
 
 		const OSEvent& event() const;
 
+		/**
+		 * @brief Replaces the state of the event with a newer one, as long as no worker started processing it.
+		 * The replaced state is kept as a sample and scroll deltas are accumulated.
+		 * @returns false if the event is already being processed
+		 */
+		bool coalesce(const OSEvent& osEvent);
+
+		/**
+		 * @returns the states that were replaced by coalesce, oldest first. Only valid while processing the event.
+		 */
+		inline const std::vector<OSEvent>& samples() const { return samples_; }
+
 		/**
 		 * @returns true if the callback was the last which processed the event
 		 */
 		template<typename Callback>
 		bool process(Callback callback)
 		{
+			// once sealed the state is immutable, so the callback can read it without holding the lock
+			{
+				std::unique_lock lk(mutex_);
+				isSealed_ = true;
+			}
+
 			if (status() != Status::Canceled)
 			{
 				callback(nativeEvent_);
@@ -179,29 +225,11 @@ namespace NativeJS
 		}
 
 	private:
-		const OSEvent nativeEvent_;
+		OSEvent nativeEvent_;
 		const size_t sendCount_;
 		StrongAtomic<size_t> finishCount_;
-	};
-
-	class TimeoutEvent : public Event
-	{
-	public:
-		enum class Type
-		{
-			INIT,
-			CANCEL,
-			RESET,
-		};
-
-		TimeoutEvent(const JS::Env& env, const size_t timeoutIndex, Type type);
-		TimeoutEvent(const JS::Env& env, const size_t timeoutIndex, const std::chrono::milliseconds resolveTime, const size_t duration, const bool loop);
-
-		const Type type;
-		const JS::Env& env;
-		const size_t timeoutIndex;
-		const std::chrono::milliseconds resolveTime;
-		const size_t duration;
-		const bool loop;
+		std::mutex mutex_;
+		bool isSealed_;
+		std::vector<OSEvent> samples_;
 	};
 }
\ No newline at end of file
@@ -2,38 +2,84 @@
 
 #include "concepts.hpp"
 #include "Event.hpp"
-#include "PersistentList.hpp"
+#include "EventPool.hpp"
+#include "constants.hpp"
 
 namespace NativeJS
 {
+	/**
+	 * @brief Allocates events from per-type slab pools and keeps track of the live ones.
+	 * An allocator is owned by a single thread, events removed on any other thread are pushed onto a lock-free list
+	 * and are destroyed and recycled by the owner the next time it touches the allocator.
+	 */
 	class EventAllocator
 	{
 	public:
 		EventAllocator();
 		EventAllocator(const EventAllocator&) = delete;
 		EventAllocator(EventAllocator&&) = delete;
+		~EventAllocator();
 
-		inline size_t size() const { return list_.size(); }
+		/**
+		 * @brief Makes the calling thread the owner of the allocator.
+		 */
+		void bindToCurrentThread();
+
+		inline size_t size() const { return size_.load(std::memory_order::acquire); }
 
 		template<typename T, class... Args>
 			requires Concepts::Extends<Event, T> && std::constructible_from<T, Args...>
 		T* create(Args&&... args)
 		{
-			size_t index = list_.alloc(static_cast<Event*>(new T(std::forward<Args>(args)...)));
-			T* event = static_cast<T*>(*(list_.at(index)));
-			event->index_ = index;
+			reclaim();
+
+			T* event = pool<T>().alloc(std::forward<Args>(args)...);
+			event->allocator_ = this;
+			link(event);
+			size_.fetch_add(1, std::memory_order::release);
 			return event;
 		}
 
 		bool remove(Event* e);
 
 		template<typename Callback>
-		void forEach(Callback callback) const
+		void forEach(Callback callback)
 		{
-			list_.forEach([&](Event** event){ callback(*event); });
+			reclaim();
+
+			Event* event = live_;
+			while (event != nullptr)
+			{
+				// the callback may remove the event
+				Event* next = event->nextLive_;
+				callback(event);
+				event = next;
+			}
 		}
 
 	private:
-		PersistentList<Event*> list_;
+		template<typename T>
+		inline auto& pool() { return std::get<EventPool<T, EVENT_POOL_SLAB_SIZE>>(pools_); }
+
+		void link(Event* event);
+		void unlink(Event* event);
+		void destroy(Event* event);
+
+		/**
+		 * @brief Recycles the events that were removed on other threads.
+		 */
+		void reclaim();
+
+		std::tuple<
+			EventPool<AsyncEvent, EVENT_POOL_SLAB_SIZE>,
+			EventPool<BlockingEvent, EVENT_POOL_SLAB_SIZE>,
+			EventPool<MessageEvent, EVENT_POOL_SLAB_SIZE>,
+			EventPool<NativeEvent, EVENT_POOL_SLAB_SIZE>
+		> pools_;
+
+		Event* live_;
+		std::atomic<Event*> removed_;
+		std::atomic<size_t> size_;
+		std::thread::id ownerThread_;
 	};
-}
\ No newline at end of file
+}
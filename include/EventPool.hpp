@@ -0,0 +1,78 @@
+#pragma once
+
+#include "framework.hpp"
+
+namespace NativeJS
+{
+	/**
+	 * @brief Slab pool for a single event type. Slots are carved out of slabs of SlabSize items
+	 * and recycled through an intrusive free list, so once warmed up alloc and free never touch the heap.
+	 * A pool is not thread-safe, frees from other threads are routed through the owning EventAllocator.
+	 */
+	template<typename T, size_t SlabSize>
+	class EventPool
+	{
+		union Slot
+		{
+			Slot* next;
+			alignas(T) unsigned char storage[sizeof(T)];
+		};
+
+	public:
+		EventPool() :
+			slabs_(),
+			free_(nullptr),
+			size_(0)
+		{ }
+
+		EventPool(const EventPool&) = delete;
+		EventPool(EventPool&&) = delete;
+
+		~EventPool()
+		{
+			for (Slot* slab : slabs_)
+				::operator delete(slab);
+		}
+
+		template<class... Args>
+			requires std::constructible_from<T, Args...>
+		T* alloc(Args&&... args)
+		{
+			if (free_ == nullptr)
+				grow();
+
+			Slot* slot = free_;
+			free_ = slot->next;
+			size_++;
+			return std::construct_at(reinterpret_cast<T*>(slot->storage), std::forward<Args>(args)...);
+		}
+
+		void free(T* item)
+		{
+			std::destroy_at(item);
+			Slot* slot = reinterpret_cast<Slot*>(item);
+			slot->next = free_;
+			free_ = slot;
+			size_--;
+		}
+
+		size_t size() const { return size_; }
+		size_t capacity() const { return slabs_.size() * SlabSize; }
+
+	private:
+		void grow()
+		{
+			Slot* slab = static_cast<Slot*>(::operator new(sizeof(Slot) * SlabSize));
+			slabs_.emplace_back(slab);
+
+			for (size_t i = 0; i < SlabSize - 1; i++)
+				slab[i].next = &slab[i + 1];
+			slab[SlabSize - 1].next = free_;
+			free_ = slab;
+		}
+
+		std::vector<Slot*> slabs_;
+		Slot* free_;
+		size_t size_;
+	};
+}
@@ -2,14 +2,43 @@
 
 #include "framework.hpp"
 #include "lockfree/Queue.hpp"
+#include "lockfree/MpscQueue.hpp"
+#include "Futex.hpp"
 #include "Event.hpp"
 
 namespace NativeJS
 {
+	/**
+	 * @brief Bounded multi-producer queue of events. Consumers spin briefly and then park on a futex,
+	 * producers only issue a wake syscall when a consumer is actually parked.
+	 * With priority lanes enabled, events are popped by lane (input > completions > messages),
+	 * a lane that keeps being passed over is served once it has waited for MAX_LANE_STARVATION events.
+	 * Priority lanes assume a single consumer.
+	 * The Channel picks the queue behind every lane: the bounded MPMC ring, whose pushes fail once it is full,
+	 * or an unbounded MPSC list for inboxes, which never overflows.
+	 */
 	class EventQueue
 	{
 	public:
-		EventQueue(size_t capacity);
+		using Clock = std::chrono::steady_clock;
+
+		enum class Lane
+		{
+			Input = 0,
+			Completion,
+			Message,
+			COUNT
+		};
+
+		enum class Channel
+		{
+			MPMC,
+			MPSC
+		};
+
+		static Lane laneOf(const Event* event);
+
+		EventQueue(size_t capacity, bool usePriorityLanes = false, Channel channel = Channel::MPMC);
 		EventQueue(const EventQueue&) = delete;
 		EventQueue(EventQueue&&) = delete;
 		~EventQueue();
@@ -18,15 +47,73 @@ namespace NativeJS
 		bool tryPopEvent(Event*& event);
 		bool popEvent(Event*& event);
 		bool popEvent(Event*& event, size_t tickTimeout);
+		bool popEvent(Event*& event, Clock::time_point deadline);
+
+		/**
+		 * @brief Posts the events with a single notification.
+		 * @returns the number of events that were posted
+		 */
+		size_t pushBatch(std::span<Event* const> events);
+		size_t tryPopBatch(std::span<Event*> events);
+		size_t popBatch(std::span<Event*> events);
+		size_t popBatch(std::span<Event*> events, size_t tickTimeout);
+		size_t popBatch(std::span<Event*> events, Clock::time_point deadline);
 
 		const size_t size() const;
 
+		/**
+		 * @returns the number of events waiting in the lane, always 0 for the lanes of a FIFO queue except Lane::Input
+		 */
+		const size_t size(Lane lane) const;
+
+		inline bool hasPriorityLanes() const { return laneCount_ > 1; }
+		inline Channel channel() const { return channel_; }
+
 	private:
-		LockFree::Queue<Event*> queue_;
-		std::mutex mutex_;
-		std::condition_variable cv_;
+		/**
+		 * @brief Pushes the event without waking a consumer.
+		 */
+		bool push(Event* event);
+		size_t pop(std::span<Event*> events);
+		size_t popLane(size_t lane, std::span<Event*> events);
+		size_t laneSize(size_t lane) const;
+		size_t pickLane() const;
+		void notify(bool all);
+
+		/**
+		 * @returns false if the deadline passed without any event being posted
+		 */
+		bool waitForEvents(const std::optional<Clock::time_point>& deadline);
+
+		/**
+		 * @brief Calls fn with the queue of the lane, whose type depends on the channel.
+		 */
+		template<typename Fn>
+		decltype(auto) withLane(size_t lane, Fn&& fn) const
+		{
+			switch (channel_)
+			{
+				case Channel::MPSC:
+					return fn(*lanes_[lane].mpsc);
+				default:
+					return fn(*lanes_[lane].mpmc);
+			}
+		}
+
+		union LaneQueue
+		{
+			LockFree::Queue<Event*>* mpmc;
+			LockFree::MpscQueue<Event*>* mpsc;
+		};
+
+		LaneQueue lanes_[static_cast<size_t>(Lane::COUNT)];
+		size_t starvation_[static_cast<size_t>(Lane::COUNT)];
+		const size_t laneCount_;
+		const Channel channel_;
+		Futex signal_;
+		std::atomic<uint32_t> sleepers_;
 		std::thread::id threadID_;
 
 		friend class App;
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "framework.hpp"
+
+namespace NativeJS
+{
+	class Worker;
+
+	/**
+	 * @brief Registry of the workers that want to receive a native message type.
+	 */
+	class EventSubscriptions
+	{
+	public:
+		EventSubscriptions();
+		EventSubscriptions(const EventSubscriptions&) = delete;
+		EventSubscriptions(EventSubscriptions&&) = delete;
+		~EventSubscriptions();
+
+		void subscribe(Worker* worker, UINT uMsg);
+		void unsubscribe(Worker* worker, UINT uMsg);
+		void unsubscribeAll(Worker* worker);
+
+		/**
+		 * @brief Appends the workers subscribed to uMsg to subscribers.
+		 */
+		void collect(UINT uMsg, std::vector<Worker*>& subscribers) const;
+
+	private:
+		mutable std::mutex mutex_;
+		std::unordered_map<UINT, std::vector<Worker*>> subscribers_;
+	};
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "framework.hpp"
+
+namespace NativeJS
+{
+	/**
+	 * @brief A 32-bit word that threads can block on until it changes, backed by futex on Linux and WaitOnAddress on Windows.
+	 */
+	class Futex
+	{
+	public:
+		Futex(uint32_t value = 0);
+		Futex(const Futex&) = delete;
+		Futex(Futex&&) = delete;
+		~Futex();
+
+		/**
+		 * @brief Blocks while the word equals expected. May return spuriously.
+		 */
+		void wait(uint32_t expected);
+
+		/**
+		 * @brief Blocks while the word equals expected, for at most timeout. May return spuriously.
+		 * @returns false if the timeout elapsed
+		 */
+		bool waitFor(uint32_t expected, std::chrono::nanoseconds timeout);
+
+		void wakeOne();
+		void wakeAll();
+
+		inline uint32_t load(std::memory_order order = std::memory_order::seq_cst) const { return value_.load(order); }
+		inline uint32_t increment(std::memory_order order = std::memory_order::seq_cst) { return value_.fetch_add(1, order); }
+
+		/**
+		 * @brief Hints the cpu that the calling thread is busy-waiting.
+		 */
+		static inline void pause()
+		{
+#if defined(_M_X64) || defined(__x86_64__)
+			_mm_pause();
+#else
+			std::this_thread::yield();
+#endif
+		}
+
+	private:
+		std::atomic<uint32_t> value_;
+
+		static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+	};
+}
@@ -20,12 +20,26 @@ namespace NativeJS
 			return hash;
 		}
 
+		constexpr static Hash hashBytes(std::string_view str)
+		{
+			uint64_t hash = 5381;
+
+			for (const char c : str)
+				hash = ((hash << 5) + hash) * 33 + static_cast<unsigned char>(c);
+
+			return hash;
+		}
+
 	public:
 		template<typename T>
 		constexpr static Hash hash() noexcept { return hashString(typeid(T).name()); }
 		constexpr static Hash hash(const char* str) noexcept { return hashString(str); }
 		constexpr static Hash hash(std::string&& str) noexcept { return hashString(str.c_str()); }
 		constexpr static Hash hash(const std::string& str) noexcept { return hashString(str.c_str()); }
+		/**
+		 * @brief Hashes every byte of str, including embedded null characters, e.g. the contents of a file.
+		 */
+		constexpr static Hash hash(std::string_view str) noexcept { return hashBytes(str); }
 		constexpr static bool check(Hash& hashStr, const char* str) noexcept { return hash(str) == hashStr; }
 	};
 }
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "framework.hpp"
+
+namespace NativeJS
+{
+	namespace JS
+	{
+		class BaseEnv;
+	}
+
+	/**
+	 * @brief The V8 heap sizing of a worker. Sizes of 0 keep the V8 defaults.
+	 */
+	struct HeapLimits
+	{
+		/**
+		 * @brief What a worker does when its heap gets close to maxOldGenerationMb.
+		 * The limit is raised once so the action can run, a worker that hits the raised limit as well is always terminated.
+		 */
+		enum class Action
+		{
+			Collect,
+			Emit,
+			Terminate
+		};
+
+		size_t maxOldGenerationMb = 0;
+		size_t maxYoungGenerationMb = 0;
+		size_t codeRangeMb = 0;
+		Action onNearLimit = Action::Collect;
+
+		/**
+		 * @brief Overrides the limits that are set in the object, e.g. { maxOldGenerationMb: 256, onNearLimit: "emit" }.
+		 * @returns false if the value is not an object
+		 */
+		bool load(const JS::BaseEnv& env, v8::Local<v8::Value> val);
+
+		void apply(v8::ResourceConstraints& constraints) const;
+
+		bool operator==(const HeapLimits&) const = default;
+	};
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "framework.hpp"
+
+namespace NativeJS
+{
+	/**
+	 * @brief App-wide cache of module resolutions, shared by all workers.
+	 * Resolved imports are keyed by (referrer directory, specifier). Existence checks below the app directory are answered
+	 * from a single scan of it instead of a stat per candidate. On Linux the scan can be kept up to date with inotify,
+	 * every change drops the cached resolutions. Without the watch a miss is checked with a stat, so files created later still resolve.
+	 * On Windows the scan is matched case-insensitively.
+	 */
+	class ModuleResolver
+	{
+	public:
+		ModuleResolver();
+		ModuleResolver(const ModuleResolver&) = delete;
+		ModuleResolver(ModuleResolver&&) = delete;
+		~ModuleResolver();
+
+		/**
+		 * @param suffixes tried in order when the specifier itself does not exist, see AppConfig::resolve
+		 * @param watch keep the scan up to date, only supported on Linux
+		 */
+		void initialize(const std::filesystem::path& rootDir, const std::vector<std::string>& suffixes, bool watch);
+
+		/**
+		 * @returns false if neither the specifier nor any of its suffixed variants exist
+		 */
+		bool resolve(const std::filesystem::path& fromDir, const std::string& specifier, std::filesystem::path& resolved);
+
+		/**
+		 * @brief Drops all the cached resolutions, the scan is kept.
+		 */
+		void invalidate();
+
+#ifdef __linux__
+		/**
+		 * @returns the inotify descriptor to poll, -1 if the app directory is not watched
+		 */
+		inline int watchFd() const { return watchFd_; }
+
+		/**
+		 * @brief Applies the pending inotify events to the scan.
+		 */
+		void processWatchEvents();
+#endif
+
+	private:
+		/**
+		 * @brief Answers from the scan where it can. Without a watch a path the scan misses is checked with a stat once, and a hit is added to the scan.
+		 */
+		bool exists(const std::filesystem::path& path);
+		bool isWatched() const;
+		// expects mutex_ to be held exclusively
+		void scan(const std::filesystem::path& dir);
+		void addDirectory(const std::filesystem::path& dir);
+
+		std::vector<std::string> suffixes_;
+		std::string rootDir_;
+		mutable std::shared_mutex mutex_;
+		std::unordered_set<std::string> entries_;
+		// hidden and symlinked directories are not scanned, paths below them are still checked with a stat
+		std::vector<std::string> unscanned_;
+		std::unordered_map<std::string, std::filesystem::path> resolved_;
+
+#ifdef __linux__
+		int watchFd_;
+		std::unordered_map<int, std::filesystem::path> watches_;
+#endif
+	};
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "framework.hpp"
+#include "Hasher.hpp"
+
+namespace NativeJS
+{
+	/**
+	 * @brief Read-only source of a module file shared by all workers.
+	 * An ASCII file stays in its read-only mapping and is handed to V8 as an external one-byte string without a copy,
+	 * any other UTF-8 file is decoded to UTF-16 once and handed out as an external two-byte string.
+	 * Strings keep pointing into the mapping, so a file edited in place changes them under V8 or faults once it shrinks,
+	 * sources of files that can change are copied instead, see ModuleSources::setCopied.
+	 */
+	class ModuleSource : public std::enable_shared_from_this<ModuleSource>
+	{
+	public:
+		/**
+		 * @param isCopied read the file into memory of the source instead of keeping it mapped
+		 * @returns nullptr if the file could not be mapped
+		 */
+		static std::shared_ptr<const ModuleSource> map(const std::filesystem::path& path, bool isCopied);
+
+		ModuleSource();
+		ModuleSource(const ModuleSource&) = delete;
+		ModuleSource(ModuleSource&&) = delete;
+		~ModuleSource();
+
+		/**
+		 * @brief Creates a string in the isolate that points at the shared source and keeps it alive until V8 disposes of the string.
+		 */
+		v8::MaybeLocal<v8::String> toString(v8::Isolate* isolate) const;
+
+		/**
+		 * @returns the hash of the source bytes, see CodeCache
+		 */
+		inline Hash hash() const { return hash_; }
+		inline bool isOneByte() const { return twoByte_.empty(); }
+		/**
+		 * @returns the raw characters, Latin-1 if isOneByte and UTF-16 otherwise
+		 */
+		inline std::string_view bytes() const { return isOneByte() ? std::string_view(oneByte_, oneByteLength_) : std::string_view(reinterpret_cast<const char*>(twoByte_.data()), twoByte_.size() * sizeof(char16_t)); }
+
+	private:
+		class OneByteResource;
+		class TwoByteResource;
+
+		void* mapping_;
+		size_t mappingSize_;
+		const char* oneByte_;
+		size_t oneByteLength_;
+		std::string copy_;
+		std::u16string twoByte_;
+		Hash hash_;
+	};
+
+	/**
+	 * @brief App-wide store of the mapped module sources, keyed by path.
+	 */
+	class ModuleSources
+	{
+	public:
+		ModuleSources();
+		ModuleSources(const ModuleSources&) = delete;
+		ModuleSources(ModuleSources&&) = delete;
+
+		/**
+		 * @returns nullptr if the file could not be read
+		 */
+		std::shared_ptr<const ModuleSource> get(const std::filesystem::path& path);
+
+		/**
+		 * @brief Copies the sources read from now on instead of mapping them, set when the files are edited while the app runs.
+		 */
+		void setCopied(bool isCopied);
+
+		/**
+		 * @brief Drops the stored sources, e.g. after the files changed. Strings that still use one keep it alive.
+		 */
+		void clear();
+
+	private:
+		std::shared_mutex mutex_;
+		std::unordered_map<std::string, std::shared_ptr<const ModuleSource>> sources_;
+		std::atomic<bool> isCopied_;
+	};
+}
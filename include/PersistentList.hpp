@@ -4,112 +4,218 @@
 
 namespace NativeJS
 {
-	template<typename T>
+	/**
+	 * @brief Pool of T stored in contiguous chunks of ChunkSize slots, so pointers stay valid for the lifetime of an item.
+	 * Free slots are recycled through an intrusive free list and every slot carries a generation,
+	 * which lets a Handle detect that the item it referred to has been freed (and the slot reused) since.
+	 */
+	template<typename T, size_t ChunkSize = 64>
 	class PersistentList
 	{
-		struct Node
-		{
-			template<class... Args>
-				requires std::constructible_from<T, Args...>
-			Node(const size_t index, Args&&... args) :
-				index(index),
-				data(new T(std::forward<Args>(args)...)),
-				isFree(false)
-			{ }
-
-			size_t index;
-			T* data;
+		struct Slot
+		{
+			alignas(T) unsigned char storage[sizeof(T)];
+			uint32_t index;
+			uint32_t generation;
+			uint32_t nextFree;
 			bool isFree;
+
+			inline T* data() { return reinterpret_cast<T*>(storage); }
 		};
+
+		constexpr static uint32_t NO_SLOT = std::numeric_limits<uint32_t>::max();
+
 	public:
+		struct Handle
+		{
+			uint32_t index = NO_SLOT;
+			uint32_t generation = 0;
+
+			/**
+			 * @returns the handle packed into a single integer, e.g. to hand it to JS
+			 */
+			inline size_t id() const { return (static_cast<size_t>(generation) << 32) | index; }
+			static inline Handle fromId(size_t id) { return Handle { static_cast<uint32_t>(id & 0xFFFFFFFF), static_cast<uint32_t>(id >> 32) }; }
+
+			inline bool operator==(const Handle& other) const = default;
+		};
+
 		PersistentList() :
-			size_(0),
-			free_(),
-			list_()
+			chunks_(),
+			slotCount_(0),
+			freeHead_(NO_SLOT),
+			size_(0)
 		{}
 
+		PersistentList(const PersistentList&) = delete;
+		PersistentList(PersistentList&&) = delete;
+
+		~PersistentList()
+		{
+			clear();
+		}
+
 		template<class... Args>
 			requires std::constructible_from<T, Args...>
 		size_t alloc(Args&&... args)
 		{
-			Node* node;
-			if (free_.size() > 0)
+			Slot* slot;
+			if (freeHead_ != NO_SLOT)
 			{
-				int i = free_.size() - 1;
-				node = free_[i];
-				free_.erase(free_.begin() + i);
-				node->isFree = false;
-				std::construct_at<T>(node->data, std::forward<Args>(args)...);
+				slot = slotAt(freeHead_);
+				freeHead_ = slot->nextFree;
 			}
 			else
 			{
-				const size_t l = list_.size();
-				node = new Node(l, std::forward<Args>(args)...);
-				list_.emplace_back(node);
+				if (slotCount_ == chunks_.size() * ChunkSize)
+					chunks_.emplace_back(static_cast<Slot*>(::operator new(sizeof(Slot) * ChunkSize)));
+
+				slot = slotAt(slotCount_);
+				slot->index = static_cast<uint32_t>(slotCount_);
+				slot->generation = 0;
+				slotCount_++;
 			}
 
+			slot->isFree = false;
+			slot->nextFree = NO_SLOT;
+			std::construct_at<T>(slot->data(), std::forward<Args>(args)...);
+
 			size_++;
 
-			return node->index;
+			return slot->index;
 		}
 
 		bool free(const size_t index)
 		{
-			if(index >= list_.size())
+			if (index >= slotCount_)
 				return false;
 
-			Node* node = list_.at(index);
-			node->isFree = true;
-			node->data->~T();
-			free_.emplace_back(node);
-			size_--;
-
-			return true;
+			return release(slotAt(index));
 		}
 
 		bool free(const T* data)
 		{
-			for (Node* node : list_)
-				if (!node->isFree && data == node->data)
-				{
-					node->isFree = true;
-					node->data->~T();
-					free_.emplace_back(node);
-					size_--;
-					return true;
-				}
-
-			return false;
+			Slot* slot = slotOf(data);
+			return slot != nullptr && release(slot);
+		}
+
+		bool free(const Handle& handle)
+		{
+			Slot* slot = validSlot(handle);
+			return slot != nullptr && release(slot);
 		}
 
 		template<typename Callback>
 		void forEach(Callback callback) const
 		{
-			for (Node* node : list_)
-				if (!node->isFree)
-					callback(node->data);
+			for (size_t i = 0; i < slotCount_; i++)
+			{
+				Slot* slot = slotAt(i);
+				if (!slot->isFree)
+					callback(slot->data());
+			}
 		}
 
 		void clear()
 		{
-			for (Node* node : list_)
+			for (size_t i = 0; i < slotCount_; i++)
 			{
-				if (!node->isFree)
-					node->data->~T();
-				delete node;
+				Slot* slot = slotAt(i);
+				if (!slot->isFree)
+					std::destroy_at(slot->data());
 			}
-			free_.clear();
-			list_.clear();
+
+			for (Slot* chunk : chunks_)
+				::operator delete(chunk);
+
+			chunks_.clear();
+			slotCount_ = 0;
+			freeHead_ = NO_SLOT;
 			size_ = 0;
 		}
 
 		size_t size() const { return size_; }
 
-		T* at(const size_t i) const { return list_.at(i)->data; }
+		T* at(const size_t i) const
+		{
+			assert(i < slotCount_);
+			return slotAt(i)->data();
+		}
+
+		/**
+		 * @returns the item the handle refers to or nullptr if it was freed since
+		 */
+		T* get(const Handle& handle) const
+		{
+			Slot* slot = validSlot(handle);
+			return slot != nullptr ? slot->data() : nullptr;
+		}
+
+		Handle handle(const size_t index) const
+		{
+			assert(index < slotCount_);
+			const Slot* slot = slotAt(index);
+			return Handle { slot->index, slot->generation };
+		}
+
+		/**
+		 * @returns an invalid handle if the item is not stored in the list
+		 */
+		Handle handleOf(const T* data) const
+		{
+			const Slot* slot = slotOf(data);
+			return slot != nullptr ? Handle { slot->index, slot->generation } : Handle {};
+		}
 
 	private:
-		std::vector<Node*> list_;
-		std::vector<Node*> free_;
-		size_t size_ = 0;
+		inline Slot* slotAt(const size_t index) const
+		{
+			return &chunks_[index / ChunkSize][index % ChunkSize];
+		}
+
+		/**
+		 * @returns the slot that stores the item or nullptr if the pointer does not point at an item of the list
+		 */
+		Slot* slotOf(const T* data) const
+		{
+			if (data == nullptr)
+				return nullptr;
+
+			// the storage sits at the start of the slot and the slot knows its index, which only maps back to the same address for a slot of this list
+			Slot* slot = reinterpret_cast<Slot*>(const_cast<T*>(data));
+			const size_t index = slot->index;
+			return index < slotCount_ && slotAt(index) == slot ? slot : nullptr;
+		}
+
+		Slot* validSlot(const Handle& handle) const
+		{
+			if (handle.index >= slotCount_)
+				return nullptr;
+
+			Slot* slot = slotAt(handle.index);
+			if (slot->isFree || slot->generation != handle.generation)
+				return nullptr;
+			return slot;
+		}
+
+		bool release(Slot* slot)
+		{
+			if (slot->isFree)
+				return false;
+
+			std::destroy_at(slot->data());
+			slot->isFree = true;
+			slot->generation++;
+			slot->nextFree = freeHead_;
+			freeHead_ = slot->index;
+			size_--;
+
+			return true;
+		}
+
+		std::vector<Slot*> chunks_;
+		size_t slotCount_;
+		uint32_t freeHead_;
+		size_t size_;
 	};
-}
\ No newline at end of file
+}
@@ -25,11 +25,7 @@ namespace NativeJS
 
 		~StackAllocator()
 		{
-			for (uint32_t i = sp_; i < capacity_; i++)
-			{
-				T* ref = &buffer_[i];
-				free(ref);
-			}
+			// objects that are still allocated belong to the caller, only the storage is released
 			::free(buffer_);
 			delete[] freeStack_;
 		};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "framework.hpp"
+
+namespace NativeJS
+{
+	/**
+	 * @brief Hierarchical timing wheel with a 1ms tick.
+	 * Timers are intrusive nodes owned by the caller, so scheduling and canceling never allocate and are O(1).
+	 * A wheel is not thread-safe, it is meant to be owned and advanced by a single thread.
+	 */
+	class TimerWheel
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		constexpr static size_t LEVEL_BITS = 8;
+		constexpr static size_t LEVELS = 4;
+		constexpr static size_t SLOTS = 1 << LEVEL_BITS;
+		constexpr static uint64_t SLOT_MASK = SLOTS - 1;
+
+		struct Timer
+		{
+			Timer* next = nullptr;
+			Timer* prev = nullptr;
+			uint64_t expiry = 0;
+			uint64_t interval = 0;
+			void* data = nullptr;
+
+			inline bool isScheduled() const { return next != nullptr; }
+
+			template<typename T>
+			inline T* as() const { return static_cast<T*>(data); }
+		};
+
+		TimerWheel();
+		TimerWheel(const TimerWheel&) = delete;
+		TimerWheel(TimerWheel&&) = delete;
+		~TimerWheel();
+
+		/**
+		 * @brief Schedules (or reschedules) the timer to expire after delay, repeating every interval if interval is not zero.
+		 */
+		void schedule(Timer* timer, std::chrono::milliseconds delay, std::chrono::milliseconds interval = std::chrono::milliseconds(0));
+		bool cancel(Timer* timer);
+
+		/**
+		 * @brief Advances the wheel up to the current time.
+		 * All the timers that expired since the last call are appended to expired in a single batch,
+		 * timers with an interval are rescheduled and only reported once even if multiple periods were missed.
+		 */
+		void advance(std::vector<Timer*>& expired);
+
+		/**
+		 * @returns the time at which advance should be called next or std::nullopt when there are no timers scheduled
+		 */
+		std::optional<Clock::time_point> nextExpiry() const;
+
+		inline size_t size() const { return size_; }
+
+	private:
+		uint64_t tickOf(Clock::time_point time) const;
+		void place(Timer* timer);
+		void cascade(const size_t level);
+		void unlink(Timer* timer);
+
+		Clock::time_point start_;
+		uint64_t now_;
+		size_t size_;
+		Timer slots_[LEVELS][SLOTS];
+	};
+}
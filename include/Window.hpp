@@ -2,6 +2,7 @@
 
 #include "framework.hpp"
 #include "js/JSWindow.hpp"
+#include "EventSubscriptions.hpp"
 
 namespace NativeJS
 {
@@ -17,9 +18,7 @@ namespace NativeJS
 	class Window
 	{
 	public:
-#ifdef _WINDOWS
 		using Handle = HWND;
-#endif
 		Window(WindowManager& windowManager, const std::string& title);
 		Window(WindowManager& windowManager, std::string&& title);
 		Window(const Window&) = delete;
@@ -39,6 +38,8 @@ namespace NativeJS
 		JS::Window* getJsObject(Worker* worker);
 		JS::Window* getJsObject(Worker& worker);
 
+		inline EventSubscriptions& subscriptions() { return subscriptions_; }
+
 	private:
 		template<typename Callback>
 		inline void callThreadSafe(Callback callback)
@@ -63,6 +64,7 @@ namespace NativeJS
 		bool isInitialized_;
 
 		std::unordered_map<Worker*, JS::Window> jsObjects_;
+		EventSubscriptions subscriptions_;
 		std::mutex mutex_;
 		std::atomic<bool> isLocked_;
 		std::condition_variable cv_;
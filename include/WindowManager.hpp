@@ -25,6 +25,8 @@ namespace NativeJS
 		App& app() const;
 		Window* getWindow(Window::Handle handle);
 
+		void unsubscribeAll(Worker* worker);
+
 
 	private:
 		App& app_;
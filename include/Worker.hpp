@@ -3,6 +3,8 @@
 #include "framework.hpp"
 #include "Event.hpp"
 #include "EventAllocator.hpp"
+#include "TimerWheel.hpp"
+#include "HeapLimits.hpp"
 
 namespace NativeJS
 {
@@ -18,8 +20,12 @@ namespace NativeJS
 	class Worker
 	{
 	public:
-		Worker(App& app, const std::filesystem::path& entry, Worker* parent);
-		Worker(App& app, std::filesystem::path&& entry, Worker* parent);
+		Worker(App& app, const std::filesystem::path& entry, Worker* parent, const HeapLimits& heapLimits);
+		Worker(App& app, std::filesystem::path&& entry, Worker* parent, const HeapLimits& heapLimits);
+		/**
+		 * @brief Creates a standby worker for the pool of App, which builds its env right away and waits for bind to load an entry.
+		 */
+		Worker(App& app, const HeapLimits& heapLimits);
 		Worker(const Worker&) = delete;
 		Worker(Worker&&) = delete;
 		~Worker();
@@ -29,20 +35,48 @@ namespace NativeJS
 
 		bool doAsyncWork(WorkCallback work, ResolverCallback resolver, void* data = nullptr, bool onMainThread = false);
 		bool doBlockingWork(WorkCallback work, void* data = nullptr, bool onMainThread = false);
+		/**
+		 * @brief Queues the work on the async pool without waiting for it, so several items can run at once.
+		 * @returns nullptr if the work could not be queued
+		 */
+		BlockingEvent* postBlockingWork(WorkCallback work, void* data = nullptr);
+		/**
+		 * @brief Blocks until at least one of the events is done, each done event has to be passed to removeEvent.
+		 */
+		void waitForBlockingWork(std::span<BlockingEvent* const> events);
+		/**
+		 * @brief Frees an event the worker created, e.g. a done blocking event or async work that could not be posted.
+		 */
+		void removeEvent(Event* event);
 
 		inline const JS::Env& env() const { assert(env_); return *env_; }
 		inline App& app() const { return app_; }
 		inline bool isTerminated() const { return isTerminated_.load(std::memory_order::acquire); }
 		inline bool isDetached() const { return parentWorker_ == nullptr; }
+		inline const HeapLimits& heapLimits() const { return heapLimits_; }
 		
 
 	protected:
 		int entry();
 
+	private:
+		void start();
+		/**
+		 * @brief Hands the entry to a standby worker, must be called once before anything else is posted to it.
+		 */
+		void bind(std::filesystem::path&& entry, Worker* parent);
+		/**
+		 * @returns false if the standby worker was terminated before it got an entry
+		 */
+		bool waitForEntry();
+		size_t popEvents(std::span<Event*> events, const size_t tickTimeout);
+		void resolveTimers();
+
 	private:
 		App& app_;
 		std::filesystem::path entry_;
 		Worker* parentWorker_;
+		const HeapLimits heapLimits_;
 		size_t index_;
 		std::mutex mutex_;
 		std::condition_variable cv_;
@@ -51,11 +85,17 @@ namespace NativeJS
 		std::atomic<bool> isRunning_;
 		std::atomic<bool> isBlocked_;
 		std::atomic<bool> isTerminated_;
+		// guarded by mutex_
+		bool isStandby_;
+		bool isStopping_;
 		std::mutex blockingWorkMutex_;
 		std::condition_variable blockingWorkCv_;
 
 		EventQueue* eventQueue_;
 		EventAllocator events_;
+		TimerWheel timers_;
+		std::vector<TimerWheel::Timer*> expiredTimers_;
+		std::vector<size_t> expiredTimeouts_;
 
 		JS::Env* env_;
 
@@ -5,10 +5,26 @@
 namespace NativeJS
 {
 	constexpr static size_t MAX_QUEUE_SIZE = 1024;
+	constexpr static size_t MAX_EVENT_BATCH = 64;
+	constexpr static size_t EVENT_QUEUE_SPIN_COUNT = 128;
+	constexpr static size_t MAX_LANE_STARVATION = 32;
+	constexpr static size_t MAX_COALESCED_SAMPLES = 64;
+	constexpr static size_t EVENT_POOL_SLAB_SIZE = 64;
+	constexpr static size_t ASYNC_TASK_INLINE_SIZE = 96;
+	constexpr static size_t ARRAY_BUFFER_MIN_CLASS_SHIFT = 4;
+	constexpr static size_t ARRAY_BUFFER_MAX_CLASS_SHIFT = 16;
+	constexpr static size_t ARRAY_BUFFER_CLASS_RESERVE = 16 * 1024 * 1024;
+	constexpr static size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+	constexpr static size_t NEAR_HEAP_LIMIT_HEADROOM_PERCENT = 25;
+	constexpr static int HEAP_LIMIT_EXIT_CODE = 134;
+	// even, so a chunk never splits a UTF-16 code unit
+	constexpr static size_t MODULE_STREAM_CHUNK_SIZE = 64 * 1024;
 
 #ifdef _WINDOWS
 	constexpr static size_t ASYNC_UI_WORK = WM_USER + 1;
 	constexpr static size_t BLOCKING_UI_WORK = WM_USER + 2;
 	constexpr static size_t UI_EVENT_RESULT = WM_USER + 3;
+#elif defined(__linux__)
+	constexpr static size_t MAX_EPOLL_EVENTS = 64;
 #endif
 }
\ No newline at end of file
@@ -21,12 +21,49 @@
 #pragma comment(lib, "winmm.lib")
 #pragma comment(lib, "dbghelp.lib")
 #pragma comment(lib, "shlwapi.lib")
+#pragma comment(lib, "synchronization.lib")
 
 #endif
 // ----------------  WINDOWS  ---------------- //
 
 
 
+// -----------------  LINUX  ----------------- //
+#ifdef __linux__
+
+#include <unistd.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/signalfd.h>
+#include <sys/inotify.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+// the native event pipeline is shared with Windows, so mirror the few Win32 types and messages it relies on
+using HWND = void*;
+using UINT = unsigned int;
+using UINT_PTR = uintptr_t;
+using WPARAM = uintptr_t;
+using LPARAM = intptr_t;
+using WORD = unsigned short;
+
+constexpr UINT WM_DESTROY = 0x0002;
+constexpr UINT WM_SIZE = 0x0005;
+constexpr UINT WM_CLOSE = 0x0010;
+constexpr UINT WM_QUIT = 0x0012;
+constexpr UINT WM_MOUSEMOVE = 0x0200;
+constexpr UINT WM_MOUSEWHEEL = 0x020A;
+constexpr UINT WM_USER = 0x0400;
+
+#endif
+// -----------------  LINUX  ----------------- //
+
+
+
 // -----------  STANDARD INCLUDES  ----------- //
 #include <stdio.h>
 #include <stdlib.h>
@@ -48,7 +85,28 @@
 #include <algorithm>
 #include <stack>
 #include <queue>
+#include <deque>
 #include <semaphore>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <sstream>
+#include <unordered_map>
+#include <span>
+#include <tuple>
+#include <memory>
+#include <bit>
+#include <variant>
+#include <array>
+#include <string_view>
+#include <shared_mutex>
+#include <unordered_set>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
 // -----------  STANDARD INCLUDES  ----------- //
 
 
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "framework.hpp"
+
+namespace NativeJS
+{
+	class ArrayBufferPool;
+
+	namespace JS
+	{
+		/**
+		 * @brief The ArrayBuffer allocator of a single isolate. Memory comes from the app-wide ArrayBufferPool,
+		 * the allocator only keeps the byte counters of its isolate. Buffers can be freed on any thread.
+		 */
+		class ArrayBufferAllocator : public v8::ArrayBuffer::Allocator
+		{
+		public:
+			struct Stats
+			{
+				size_t liveBytes;
+				size_t peakBytes;
+				size_t totalBytes;
+				size_t allocations;
+			};
+
+			ArrayBufferAllocator(ArrayBufferPool& pool);
+			ArrayBufferAllocator(const ArrayBufferAllocator&) = delete;
+			ArrayBufferAllocator(ArrayBufferAllocator&&) = delete;
+			virtual ~ArrayBufferAllocator() { }
+
+			virtual void* Allocate(size_t length) override;
+			virtual void* AllocateUninitialized(size_t length) override;
+			virtual void Free(void* data, size_t length) override;
+
+			Stats stats() const;
+
+		private:
+			void* alloc(size_t length, bool zeroed);
+
+			ArrayBufferPool& pool_;
+			std::atomic<size_t> liveBytes_;
+			std::atomic<size_t> peakBytes_;
+			std::atomic<size_t> totalBytes_;
+			std::atomic<size_t> allocations_;
+		};
+	}
+}
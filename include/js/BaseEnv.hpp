@@ -1,6 +1,7 @@
 #pragma once
 
 #include "framework.hpp"
+#include "HeapLimits.hpp"
 
 namespace NativeJS
 {
@@ -10,10 +11,18 @@ namespace NativeJS
 	namespace JS
 	{
 		class App;
+		class ArrayBufferAllocator;
 		class BaseEnv
 		{
 		public:
-			BaseEnv(NativeJS::App& app);
+			/**
+			 * @brief Creates the isolate from the startup snapshot of the app if one is loaded.
+			 */
+			BaseEnv(NativeJS::App& app, const HeapLimits& heapLimits = HeapLimits());
+			/**
+			 * @brief Uses the isolate of the creator, which keeps owning it.
+			 */
+			BaseEnv(NativeJS::App& app, v8::SnapshotCreator& creator);
 			BaseEnv(const BaseEnv&) = delete;
 			BaseEnv(BaseEnv&&) = delete;
 			~BaseEnv();
@@ -21,14 +30,22 @@ namespace NativeJS
 			inline NativeJS::App& app() const { return app_; }
 			inline v8::Isolate* isolate() const { return isolate_; }
 			inline v8::Local<v8::Context> context() const { return context_.Get(isolate_); }
+			inline const ArrayBufferAllocator& arrayBufferAllocator() const { return *arrayBufferAllocator_; }
+			/**
+			 * @returns true if the context was deserialized from the startup snapshot, so the runtime is already built
+			 */
+			inline bool isFromSnapshot() const { return isFromSnapshot_; }
 
 			void throwException(const char* error) const;
 
 		private:
 			NativeJS::App& app_;
+			ArrayBufferAllocator* arrayBufferAllocator_;
 			v8::Isolate::CreateParams createParams_;
 			v8::Isolate* isolate_;
-			v8::Eternal<v8::Context> context_;
+			v8::Global<v8::Context> context_;
+			v8::SnapshotCreator* snapshotCreator_;
+			bool isFromSnapshot_;
 		};
 	}
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include "js/BaseEnv.hpp"
 #include "js/Timeout.hpp"
 #include "PersistentList.hpp"
+#include "CodeCache.hpp"
 
 namespace NativeJS
 {
@@ -16,11 +17,28 @@ namespace NativeJS
 	namespace JS
 	{
 		class App;
+		class ModuleGraph;
 		class Env : public BaseEnv
 		{
 		private:
 			static void defaultAsyncResolver(const NativeJS::WorkEvent& e);
 
+			/**
+			 * @brief Raises the limit once so the worker can run its HeapLimits::Action on its own thread,
+			 * terminates the execution if the raised limit is reached as well.
+			 */
+			static size_t nearHeapLimit(void* data, size_t currentHeapLimit, size_t initialHeapLimit);
+
+			/**
+			 * @brief Sets import.meta.dirname and import.meta.filename, which replaced the __dirname/__filename prelude so module sources are passed to V8 unchanged.
+			 */
+			static void initializeImportMeta(v8::Local<v8::Context> context, v8::Local<v8::Module> module, v8::Local<v8::Object> meta);
+
+			/**
+			 * @brief Handles import(), modules that are not loaded yet are loaded off the worker thread, see ModuleGraph::import.
+			 */
+			static v8::MaybeLocal<v8::Promise> importModuleDynamically(v8::Local<v8::Context> context, v8::Local<v8::Data> hostDefinedOptions, v8::Local<v8::Value> resourceName, v8::Local<v8::String> specifier, v8::Local<v8::FixedArray> importAssertions);
+
 		public:
 			struct Scope
 			{
@@ -41,27 +59,59 @@ namespace NativeJS
 
 			Env(NativeJS::App& app, NativeJS::Worker* worker, const std::filesystem::path& entry, NativeJS::Worker* parentWorker = nullptr);
 			Env(NativeJS::App& app, NativeJS::Worker* worker, std::filesystem::path&& entry, NativeJS::Worker* parentWorker = nullptr);
+			/**
+			 * @brief Builds the classes and globals into the default context of the creator, the env can not run any code.
+			 */
+			Env(NativeJS::App& app, v8::SnapshotCreator& creator);
 			Env(const Env&) = delete;
 			Env(Env&&) = delete;
 			~Env();
 
+			/**
+			 * @brief Gives the env of a standby worker its entry and parent once the worker is taken from the pool.
+			 */
+			void bind(const std::filesystem::path& entry, NativeJS::Worker* parentWorker);
+
 			inline v8::Local<v8::External> externalRef() const { return externalRef_.Get(isolate()); }
 			inline NativeJS::Worker& worker() const { return *worker_; }
 			inline v8::Local<v8::Symbol> internalSymbol() const { return internalSymbol_.Get(isolate()); }
 
+			/**
+			 * @brief Deserializes the value of a JSON module, which is only done once when the module is evaluated.
+			 */
 			v8::MaybeLocal<v8::Value> getJsonData(const int moduleHash) const;
+			/**
+			 * @brief Compiles the module and its static imports, see ModuleGraph. The module is not instantiated.
+			 */
 			v8::MaybeLocal<v8::Module> loadModule(const char* filePath) const;
 			v8::MaybeLocal<v8::Module> loadJsonModule(const char* filePath) const;
 			void loadEntryModule() const;
 
 			v8::Local<v8::Promise> doAsyncWork(WorkCallback work, ResolverCallback resolver = Env::defaultAsyncResolver, void* data = nullptr, bool onMainThread = false) const;
+
+			/**
+			 * @brief Like doAsyncWork, but with callables that carry their own state instead of a void* data, see AsyncTask.
+			 */
+			template<typename Work, typename Resolve>
+			v8::Local<v8::Promise> doAsyncTask(Work&& work, Resolve&& resolve, bool onMainThread = false) const
+			{
+				AsyncEvent* event = createAsyncEvent(nullptr, nullptr, nullptr);
+				event->emplaceTask(std::forward<Work>(work), std::forward<Resolve>(resolve));
+				return postAsyncEvent(event, onMainThread);
+			}
 			bool doBlockingWork(WorkCallback work, void* data, bool onMainThread) const;
 
 			v8::Local<v8::Promise> sendMessageToWorker(NativeJS::Worker* receiver, std::string&& message) const;
 			v8::Local<v8::Value> createEvent(Event* event) const;
-			bool addTimeout(v8::Local<v8::Function> func, v8::Local<v8::Value> ms, v8::Local<v8::Value> timeoutObj, v8::Local<v8::Value> loopVal, size_t& index) const;
-			void resolveTimeout(const size_t index) const;
-			void removeTimeout(size_t index) const;
+			/**
+			 * @param id receives the generation-tagged id of the timeout, which stays safe to pass to removeTimeout after the timeout is freed
+			 */
+			bool addTimeout(v8::Local<v8::Function> func, v8::Local<v8::Value> ms, v8::Local<v8::Value> timeoutObj, v8::Local<v8::Value> loopVal, size_t& id) const;
+			void resolveTimeout(const size_t id) const;
+			/**
+			 * @returns false if the timeout already finished or was removed
+			 */
+			bool removeTimeout(size_t id) const;
 
 				void initializeJSApp(v8::Local<v8::Value> value) const;
 			bool isJsAppInitialized() const;
@@ -77,8 +127,37 @@ namespace NativeJS
 			bool isSelfWorker(NativeJS::Worker* worker) const;
 			void emitMessage(MessageEvent& e);
 
+			/**
+			 * @brief Runs the near-heap-limit action of the worker if the heap got close to its limit since the last call.
+			 * @returns false if the worker has to stop
+			 */
+			bool handleNearHeapLimit() const;
+
+			/**
+			 * @brief Drops the dynamic imports that are still loading, once their work on the async pool returned.
+			 */
+			void cancelImports() const;
+
 		private:
 			void initialize(NativeJS::Worker* worker);
+			void addParentJsWorker();
+			/**
+			 * @param referrerPath path of the importing module, relative imports of unknown modules are resolved against the app directory if empty
+			 * @returns false for the native-js module and imports that do not exist
+			 */
+			bool resolveImport(const std::string& referrerPath, std::string import, std::filesystem::path& resolved) const;
+			v8::MaybeLocal<v8::Module> findModule(const std::string& path) const;
+			void addModule(const std::string& path, v8::Local<v8::Module> module) const;
+			/**
+			 * @brief Writes the code cache of the modules compiled without a usable entry, called once they were evaluated.
+			 */
+			void storeCodeCache() const;
+			/**
+			 * @brief Instantiates and evaluates the module of an import() and settles its promise with the module namespace.
+			 */
+			void evaluateImport(v8::Local<v8::Module> module, v8::Local<v8::Promise::Resolver> resolver) const;
+			AsyncEvent* createAsyncEvent(WorkCallback work, ResolverCallback resolver, void* data) const;
+			v8::Local<v8::Promise> postAsyncEvent(AsyncEvent* event, bool onMainThread) const;
 
 		private:
 			NativeJS::Worker* parentWorker_;
@@ -96,9 +175,18 @@ namespace NativeJS
 
 			mutable std::unordered_map<int, std::string> modulesPaths_;
 			mutable std::unordered_map<std::string, v8::Persistent<v8::Module>*> modules_;
-			mutable std::unordered_map<int, v8::Persistent<v8::Value>*> jsonModules_;
+			// serialized values of the JSON modules that were not evaluated yet, keyed by the identity hash of the module
+			mutable std::unordered_map<int, CodeCache::Data> jsonModules_;
+			mutable std::vector<std::pair<Hash, v8::Global<v8::Module>>> uncachedModules_;
+			// the async graphs of the dynamic imports in flight
+			mutable std::unordered_map<ModuleGraph*, std::unique_ptr<ModuleGraph>> imports_;
 
 			mutable PersistentList<Timeout> timeouts_;
+			mutable std::atomic<bool> isNearHeapLimit_;
+			// set by nearHeapLimit when it terminated the execution
+			std::atomic<bool> mustTerminate_;
+
+			friend class ModuleGraph;
 		};
 	}
 }
\ No newline at end of file
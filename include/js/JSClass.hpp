@@ -13,6 +13,7 @@ public: void __NAME__(std::initializer_list<v8::Local<v8::Value>> args = {});
 #define JS_CLASS_BODY(__NAME__) public: \
 	__NAME__(const Env& env) : Class(env) { } \
 	~__NAME__() {  } \
+	friend class Snapshot; \
 protected: \
 	virtual void create(const ClassBuilder& builder);
 
@@ -29,6 +30,7 @@ namespace NativeJS
 	namespace JS
 	{
 		class Env;
+		class Snapshot;
 
 		class ObjectWrapper
 		{
@@ -64,33 +66,28 @@ namespace NativeJS
 
 		class ClassBuilder
 		{
+			friend class Snapshot;
+
 		private:
 			static void emptyFunction(const v8::FunctionCallbackInfo<v8::Value>& args);
 		public:
-			ClassBuilder(const Env& env, void* self);
+			ClassBuilder(const Env& env);
 
 			const ClassBuilder& setStatic(const char* key, v8::Local<v8::Value> val, bool readonly = false) const;
 
 			const ClassBuilder& setStaticMethod(const char* name, v8::FunctionCallback callback = ClassBuilder::emptyFunction, v8::Local<v8::Value> data = v8::Local<v8::Value>()) const;
 
-			const ClassBuilder& setStaticMethod(const char* name, v8::FunctionCallback callback, void* data) const;
-
 			const ClassBuilder& set(const char* key, v8::Local<v8::Value> val, bool readonly = false, bool isPrivate = false) const;
 
 			const ClassBuilder& setMethod(const char* name, v8::FunctionCallback callback = ClassBuilder::emptyFunction, v8::Local<v8::Value> data = v8::Local<v8::Value>(), v8::PropertyAttribute attr = v8::PropertyAttribute::None) const;
-			
-			const ClassBuilder& setMethod(const char* name, v8::FunctionCallback callback, void* data) const;
 
 			const ClassBuilder& setInternalFieldCount(const int count) const;
 
 			const ClassBuilder& setConstructor(v8::FunctionCallback callback, v8::Local<v8::Value> data = v8::Local<v8::Value>()) const;
 
-			const ClassBuilder& setConstructor(v8::FunctionCallback callback, void* data) const;
-
 			v8::Local<v8::Function> getClass() const;
 
 		private:
-			void* self_;
 			const Env& env_;
 			mutable size_t internalFieldCount_;
 			v8::Local<v8::FunctionTemplate> template_;
@@ -105,6 +102,10 @@ namespace NativeJS
 			virtual ~Class() = 0;
 
 			void initialize();
+			/**
+			 * @brief Takes over the class of a context deserialized from the startup snapshot instead of building it.
+			 */
+			void restore(v8::Local<v8::Function> jsClass);
 			v8::Local<v8::Function> getClass() const;
 
 			v8::MaybeLocal<v8::Value> instantiate(const std::vector<v8::Local<v8::Value>>& args = {}) const;
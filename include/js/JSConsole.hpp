@@ -14,6 +14,9 @@ namespace NativeJS
 			std::string parse(const Env& env, v8::Local<v8::Value> val, size_t indentCount = 0, bool isObjectVal = false, bool skipIndent = false);
 			void logValue(const Env& env, v8::Local<v8::Value> val);
 
+			void log(const v8::FunctionCallbackInfo<v8::Value>& args);
+			void clear(const v8::FunctionCallbackInfo<v8::Value>& args);
+
 			void expose(const Env& env, JS::Object& global);
 		}
 	};
@@ -24,9 +24,19 @@ namespace NativeJS
 
 			void initialize();
 
+			/**
+			 * @brief Attaches the classes to the context of the startup snapshot, in the order deserialize reads them back.
+			 */
+			void serialize(v8::SnapshotCreator& creator, v8::Local<v8::Context> context) const;
+			void deserialize(v8::Local<v8::Context> context);
+
 			inline bool isInitialized() const { return isInitialized_; };
 
 		private:
+			// also the order of the classes in the startup snapshot
+			inline std::array<Class*, 5> list() { return { &windowClass, &appClass, &eventClass, &workerClass, &timeoutClass }; }
+			inline std::array<const Class*, 5> list() const { return { &windowClass, &appClass, &eventClass, &workerClass, &timeoutClass }; }
+
 			bool isInitialized_;
 		};
 	}
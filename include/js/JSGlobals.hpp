@@ -9,6 +9,9 @@ namespace NativeJS
 
 		namespace JSGlobals
 		{
+			/**
+			 * @brief Exposes the globals that are the same for every env, so they can be part of the startup snapshot.
+			 */
 			void expose(const Env& env, Object& obj);
 		}
 	}
@@ -21,6 +21,9 @@ namespace NativeJS
 			JS_METHOD_DECL(onClose);
 			JS_METHOD_DECL(onClosed);
 			JS_METHOD_DECL(onLoad);
+			JS_METHOD_DECL(onMouseMove);
+			JS_METHOD_DECL(onResize);
+			JS_METHOD_DECL(onScroll);
 		};
 
 		class WindowClass : public Class
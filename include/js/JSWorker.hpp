@@ -18,9 +18,14 @@ namespace NativeJS
 			JS_METHOD_DECL(terminate);
 
 			void emitMessage(const std::string& str);
+			/**
+			 * @brief Calls the onHeapLimit listeners, which a message can never reach.
+			 */
+			void emitHeapLimit();
 
 		private:
 			v8::Persistent<v8::Object> listeners_;
+			v8::Persistent<v8::Array> heapLimitListeners_;
 		};
 
 		class WorkerClass : public Class
@@ -33,6 +38,7 @@ namespace NativeJS
 			JS_CLASS_METHOD(terminate);
 			JS_CLASS_METHOD(send);
 			JS_CLASS_METHOD(onMessage);
+			JS_CLASS_METHOD(onHeapLimit);
 		};
 	}
 }
\ No newline at end of file
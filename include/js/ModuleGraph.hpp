@@ -0,0 +1,90 @@
+#pragma once
+
+#include "framework.hpp"
+#include "CodeCache.hpp"
+#include "ModuleSources.hpp"
+
+namespace NativeJS
+{
+	class App;
+	class BlockingEvent;
+
+	namespace JS
+	{
+		class Env;
+
+		/**
+		 * @brief Compiles a module together with everything it statically imports before it is instantiated.
+		 * Sources without a code cache entry are parsed with V8's streaming compiler on the async pool, all the modules
+		 * of the graph that are known at a time in parallel, only finalizing and resolving the imports run on the worker.
+		 */
+		class ModuleGraph
+		{
+		public:
+			/**
+			 * @brief Loads the module of a dynamic import() without blocking the worker. The files are read and parsed on the async pool
+			 * and the graph is continued from the event queue of the worker, the resolver is settled once the module was evaluated.
+			 * The graph is owned by the env, which cancels it if the worker stops first.
+			 * @param path absolute and normalized, see Env::resolveImport
+			 */
+			static void import(const Env& env, const std::filesystem::path& path, v8::Local<v8::Promise::Resolver> resolver);
+
+			ModuleGraph(const Env& env);
+			ModuleGraph(const ModuleGraph&) = delete;
+			ModuleGraph(ModuleGraph&&) = delete;
+			~ModuleGraph();
+
+			/**
+			 * @brief Blocks the worker until the module and its imports are compiled, Env::importModule then finds them when the module is instantiated.
+			 * @param path absolute and normalized, see Env::resolveImport
+			 */
+			v8::MaybeLocal<v8::Module> load(const std::filesystem::path& path);
+
+		private:
+			class SourceStream;
+			struct PendingModule;
+
+			static void read(PendingModule& pending, NativeJS::App& app);
+
+			inline bool isAsync() const { return !resolver_.IsEmpty(); }
+
+			void fetch(const std::filesystem::path& path);
+			/**
+			 * @brief Moves the module to its next step: streaming it once its source was read, compiling it once it was parsed.
+			 */
+			void advance(std::unique_ptr<PendingModule> pending);
+			/**
+			 * @brief Keeps the work of an async graph that did not start yet from running and waits for the work that did.
+			 */
+			void cancel();
+			/**
+			 * @brief Runs the work of an async graph on the async pool and advances the module from the event queue of the worker.
+			 */
+			void post(std::unique_ptr<PendingModule> pending, void (*work)(PendingModule& pending, NativeJS::App& app));
+			void compile(PendingModule& pending);
+			void fetchImports(const std::string& path, v8::Local<v8::Module> module);
+			void waitForStreaming();
+			/**
+			 * @brief Compiles the modules that are ready and settles the import once nothing is in flight anymore, which deletes the graph.
+			 */
+			void continueImport();
+
+			const Env& env_;
+			std::unordered_set<std::string> fetched_;
+			std::deque<std::unique_ptr<PendingModule>> ready_;
+			std::vector<std::unique_ptr<PendingModule>> streaming_;
+
+			std::string importPath_;
+			v8::Global<v8::Promise::Resolver> resolver_;
+			// the first exception a module of an async graph threw while compiling, the import is rejected with it
+			v8::Global<v8::Value> exception_;
+			// the modules whose work was posted, until they are advanced
+			std::unordered_map<PendingModule*, std::unique_ptr<PendingModule>> posted_;
+			std::atomic<bool> isCanceled_;
+			std::mutex mutex_;
+			std::condition_variable cv_;
+			// guarded by mutex_, the posted work that did not return from the async pool yet
+			size_t runningCount_;
+		};
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "framework.hpp"
+
+namespace NativeJS
+{
+	class App;
+
+	namespace JS
+	{
+		/**
+		 * @brief V8 startup snapshot of a context with the native-js classes and globals already built.
+		 * The native-js module is a synthetic module, which V8 can not serialize, so every Env still creates it on startup.
+		 */
+		class Snapshot
+		{
+		public:
+			/**
+			 * @brief The native callbacks reachable from the snapshot, null-terminated as V8 expects.
+			 */
+			static const intptr_t* externalReferences();
+
+			/**
+			 * @brief Builds the runtime in a fresh isolate and writes its snapshot to path.
+			 */
+			static bool build(NativeJS::App& app, const std::filesystem::path& path);
+
+			Snapshot();
+			Snapshot(const Snapshot&) = delete;
+			Snapshot(Snapshot&&) = delete;
+
+			/**
+			 * @returns false if the file could not be read or was built by another V8 version
+			 */
+			bool load(const std::filesystem::path& path);
+
+			inline bool isLoaded() const { return !data_.empty(); }
+			inline v8::StartupData* startupData() { return &startupData_; }
+
+		private:
+			std::vector<char> data_;
+			v8::StartupData startupData_;
+		};
+	}
+}
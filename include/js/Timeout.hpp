@@ -1,6 +1,7 @@
 #pragma once
 
 #include "js/JSClass.hpp"
+#include "TimerWheel.hpp"
 
 namespace NativeJS
 {
@@ -20,17 +21,23 @@ namespace NativeJS
 
 			virtual void initializeProps();
 			bool shouldResolve(std::chrono::milliseconds time);
-			void setIndex(size_t index);
+			void setId(size_t id);
+			void terminate();
 			
 			JS_METHOD_DECL(resolve);
 		
-			inline size_t index() const { return index_; }
+			/**
+			 * @returns the generation-tagged id of the timeout in the timeouts of its env
+			 */
+			inline size_t id() const { return id_; }
+			inline TimerWheel::Timer* timer() { return std::addressof(timer_); }
 			inline bool loop() const { return loop_; }
 			inline bool isTerminated() const { return isTerminated_; }
 
 
 		private:
-			size_t index_;
+			size_t id_;
+			TimerWheel::Timer timer_;
 			const bool loop_;
 			bool isTerminated_;
 			std::chrono::milliseconds resolveTime_;
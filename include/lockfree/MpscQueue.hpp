@@ -0,0 +1,166 @@
+#pragma once
+
+#include "framework.hpp"
+#include "ConcurrentStackAllocator.hpp"
+
+namespace NativeJS
+{
+	namespace LockFree
+	{
+		/**
+		 * @brief Unbounded intrusive queue for any number of producers and a single consumer.
+		 * Items live inline in linked nodes, a push is one exchange on the head and never fails.
+		 * Nodes come from a ConcurrentStackAllocator, so the nodes the consumer frees are recycled by the producers without a lock
+		 * and a warm queue does not allocate.
+		 * Supports move-only element types.
+		 * A pop can miss an item whose producer was preempted between the exchange and the link, size() already counts it.
+		 */
+		template <typename T>
+		class MpscQueue
+		{
+		public:
+			/**
+			 * @param cachedNodes the number of free nodes the allocator's depot holds before it grows
+			 */
+			explicit MpscQueue(size_t cachedNodes) :
+				_nodes(std::max<size_t>(cachedNodes / NODE_BATCH_SIZE, 1))
+			{
+				_stub.next.store(nullptr, std::memory_order_relaxed);
+				_tail = &_stub;
+				_head.store(&_stub, std::memory_order_relaxed);
+				_size.store(0, std::memory_order_relaxed);
+			}
+
+			MpscQueue(const MpscQueue&) = delete;
+			MpscQueue(MpscQueue&&) = delete;
+
+			~MpscQueue()
+			{
+				Node* node = _tail;
+				for (Node* next = node->next.load(std::memory_order_acquire); next != nullptr; next = node->next.load(std::memory_order_acquire))
+				{
+					next->get()->~T();
+					releaseNode(node);
+					node = next;
+				}
+				releaseNode(node);
+			}
+
+			size_t capacity() const { return std::numeric_limits<size_t>::max(); }
+
+			size_t size() const { return _size.load(std::memory_order_acquire); }
+
+			template<class... Args>
+				requires std::constructible_from<T, Args...>
+			bool push(Args&&... args)
+			{
+				Node* node = acquireNode();
+				new (node->storage)T(std::forward<Args>(args)...);
+				node->next.store(nullptr, std::memory_order_relaxed);
+
+				_size.fetch_add(1, std::memory_order_release);
+				link(node, node);
+				return true;
+			}
+
+			/**
+			 * @brief Links all items with a single exchange, so they stay consecutive even with concurrent producers.
+			 * @returns items.size()
+			 */
+			size_t pushBatch(std::span<const T> items)
+			{
+				if (items.empty())
+					return 0;
+
+				Node* first = nullptr;
+				Node* last = nullptr;
+				for (const T& item : items)
+				{
+					Node* node = acquireNode();
+					new (node->storage)T(item);
+					node->next.store(nullptr, std::memory_order_relaxed);
+					if (last != nullptr)
+						last->next.store(node, std::memory_order_relaxed);
+					else
+						first = node;
+					last = node;
+				}
+
+				_size.fetch_add(items.size(), std::memory_order_release);
+				link(first, last);
+				return items.size();
+			}
+
+			bool pop(T& result)
+			{
+				Node* tail = _tail;
+				Node* next = tail->next.load(std::memory_order_acquire);
+				if (next == nullptr)
+					return false;
+
+				T* data = next->get();
+				result = std::move(*data);
+				data->~T();
+
+				// the popped node stays behind as the new (empty) tail
+				_tail = next;
+				releaseNode(tail);
+				_size.fetch_sub(1, std::memory_order_release);
+				return true;
+			}
+
+			/**
+			 * @returns the number of items that were popped
+			 */
+			size_t popBatch(std::span<T> result)
+			{
+				size_t count = 0;
+				while (count < result.size() && pop(result[count]))
+					count++;
+				return count;
+			}
+
+		private:
+			constexpr static size_t NODE_BATCH_SIZE = 32;
+
+			struct Node
+			{
+				std::atomic<Node*> next;
+				alignas(T) unsigned char storage[sizeof(T)];
+
+				inline T* get() { return std::launder(reinterpret_cast<T*>(storage)); }
+			};
+
+			void link(Node* first, Node* last)
+			{
+				Node* prev = _head.exchange(last, std::memory_order_acq_rel);
+				prev->next.store(first, std::memory_order_release);
+			}
+
+			Node* acquireNode()
+			{
+				return _nodes.alloc();
+			}
+
+			void releaseNode(Node* node)
+			{
+				if (node == &_stub)
+					return;
+				_nodes.free(node);
+			}
+
+		private:
+			ConcurrentStackAllocator<Node, 256, NODE_BATCH_SIZE> _nodes;
+			Node _stub;
+			char cacheLinePad1[64];
+			// consumer side
+			Node* _tail;
+			char cacheLinePad2[64];
+			// producer side
+			std::atomic<Node*> _head;
+			char cacheLinePad3[64];
+			std::atomic<size_t> _size;
+			char cacheLinePad4[64];
+		};
+	}
+}
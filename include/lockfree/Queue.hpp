@@ -34,9 +34,9 @@ namespace NativeJS
 			~Queue()
 			{
 				for (size_t i = _head; i != _tail; ++i)
-					(&_queue[i & _capacityMask].data)->~T();
+					_queue[i & _capacityMask].get()->~T();
 
-				delete _queue;
+				delete[] _queue;
 			}
 
 			size_t capacity() const { return _capacity; }
@@ -54,12 +54,12 @@ namespace NativeJS
 				for (;;)
 				{
 					node = &_queue[tail & _capacityMask];
-					if (node->tail.load(std::memory_order_relaxed) != tail)
+					if (node->tail.load(std::memory_order_acquire) != tail)
 						return false;
 					if ((_tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed)))
 						break;
 				}
-				new (&node->data)T(data);
+				new (node->storage)T(data);
 				node->head.store(tail, std::memory_order_release);
 				return true;
 			}
@@ -74,12 +74,12 @@ namespace NativeJS
 				for (;;)
 				{
 					node = &_queue[tail & _capacityMask];
-					if (node->tail.load(std::memory_order_relaxed) != tail)
+					if (node->tail.load(std::memory_order_acquire) != tail)
 						return false;
 					if ((_tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed)))
 						break;
 				}
-				new (&node->data)T(std::forward<Args>(args)...);
+				new (node->storage)T(std::forward<Args>(args)...);
 				node->head.store(tail, std::memory_order_release);
 				return true;
 			}
@@ -91,23 +91,82 @@ namespace NativeJS
 				for (;;)
 				{
 					node = &_queue[head & _capacityMask];
-					if (node->head.load(std::memory_order_relaxed) != head)
+					if (node->head.load(std::memory_order_acquire) != head)
 						return false;
 					if (_head.compare_exchange_weak(head, head + 1, std::memory_order_relaxed))
 						break;
 				}
-				result = node->data;
-				(&node->data)->~T();
+				result = std::move(*node->get());
+				node->get()->~T();
 				node->tail.store(head + _capacity, std::memory_order_release);
 				return true;
 			}
 
+			/**
+			 * @brief Reserves as many consecutive free slots as possible with a single CAS and fills them in order.
+			 * @returns the number of items that were pushed, which is less than items.size() when the queue is (nearly) full
+			 */
+			size_t pushBatch(std::span<const T> items)
+			{
+				size_t count;
+				size_t tail = _tail.load(std::memory_order_relaxed);
+				for (;;)
+				{
+					count = 0;
+					while (count < items.size() && _queue[(tail + count) & _capacityMask].tail.load(std::memory_order_acquire) == tail + count)
+						count++;
+					if (count == 0)
+						return 0;
+					if (_tail.compare_exchange_weak(tail, tail + count, std::memory_order_relaxed))
+						break;
+				}
+
+				for (size_t i = 0; i < count; i++)
+				{
+					Node* node = &_queue[(tail + i) & _capacityMask];
+					new (node->storage)T(items[i]);
+					node->head.store(tail + i, std::memory_order_release);
+				}
+				return count;
+			}
+
+			/**
+			 * @brief Claims up to result.size() consecutive published items with a single CAS.
+			 * @returns the number of items that were popped
+			 */
+			size_t popBatch(std::span<T> result)
+			{
+				size_t count;
+				size_t head = _head.load(std::memory_order_relaxed);
+				for (;;)
+				{
+					count = 0;
+					while (count < result.size() && _queue[(head + count) & _capacityMask].head.load(std::memory_order_acquire) == head + count)
+						count++;
+					if (count == 0)
+						return 0;
+					if (_head.compare_exchange_weak(head, head + count, std::memory_order_relaxed))
+						break;
+				}
+
+				for (size_t i = 0; i < count; i++)
+				{
+					Node* node = &_queue[(head + i) & _capacityMask];
+					result[i] = std::move(*node->get());
+					node->get()->~T();
+					node->tail.store(head + i + _capacity, std::memory_order_release);
+				}
+				return count;
+			}
+
 		private:
 			struct Node
 			{
-				T data;
+				alignas(T) unsigned char storage[sizeof(T)];
 				std::atomic<size_t> tail;
 				std::atomic<size_t> head;
+
+				inline T* get() { return std::launder(reinterpret_cast<T*>(storage)); }
 			};
 
 		private:
@@ -46,7 +46,7 @@ namespace NativeJS
 					(&node.data)->~T();
 				}
 
-				delete _queue;
+				delete[] _queue;
 			}
 
 			size_t capacity() const { return _capacity; }
@@ -33,5 +33,11 @@ namespace NativeJS
 		{
 			return std::chrono::duration_cast<T>(std::chrono::system_clock::now().time_since_epoch());
 		}
+
+		template<typename T>
+		T monotonicNow()
+		{
+			return std::chrono::duration_cast<T>(std::chrono::steady_clock::now().time_since_epoch());
+		}
 	}
 }
\ No newline at end of file
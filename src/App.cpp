@@ -3,13 +3,13 @@
 #include "constants.hpp"
 #include "js/Env.hpp"
 #include "js/JSUtils.hpp"
-#include "AsyncWorker.hpp"
 
 namespace NativeJS
 {
 	static const std::string MAX_V8_WORKERS_STR = "MAX_V8_WORKERS_THREADS";
 	static const std::string MAX_ASYNC_WORKERS_STR = "MAX_ASYNC_WORKERS";
 	static const std::string TICK_TIMEOUT_STR = "TICK_TIMEOUT";
+	static const std::string BUILD_SNAPSHOT_STR = "BUILD_SNAPSHOT";
 
 	App* App::currentInstance_ = nullptr;
 
@@ -27,6 +27,7 @@ namespace NativeJS
 		size_t tickTimeout = 0;
 
 		std::filesystem::path startDir;
+		std::filesystem::path snapshotOutput;
 
 		if (argc > 0 && argv[0][0] != '-')
 		{
@@ -66,9 +67,13 @@ namespace NativeJS
 				std::stringstream sstream(val);
 				sstream >> tickTimeout;
 			}
+			else if (str.starts_with(BUILD_SNAPSHOT_STR))
+			{
+				snapshotOutput = std::string(&str.data()[BUILD_SNAPSHOT_STR.length() + 1]);
+			}
 		}
 
-		App::currentInstance_ = new App(argc, argv, std::move(startDir), maxAsyncWorkers, maxPlatformWorkers, tickTimeout);
+		App::currentInstance_ = new App(argc, argv, std::move(startDir), maxAsyncWorkers, maxPlatformWorkers, tickTimeout, std::move(snapshotOutput));
 		return *App::currentInstance_;
 	}
 
@@ -93,20 +98,37 @@ namespace NativeJS
 		return exitCode;
 	}
 
-	App::App(int argc, char** argv, std::filesystem::path&& rootDir, const size_t maxAsyncWorkers, const size_t maxV8PlatformThreads, const size_t tickTimeout) :
+	App::App(int argc, char** argv, std::filesystem::path&& rootDir, const size_t maxAsyncWorkers, const size_t maxV8PlatformThreads, const size_t tickTimeout, std::filesystem::path&& snapshotOutput) :
 		argc_(argc),
 		argv_(argv),
 		tickTimeout_(tickTimeout),
+#ifdef _WINDOWS
 		mainThreadID_(GetCurrentThreadId()),
+#else
+		mainThreadID_(std::this_thread::get_id()),
+#endif
 		rootDir_(rootDir),
 		logger_(Logger::get()),
 		exitCode_(0),
-		asyncWorkers_(),
-		asyncEventQueue_(MAX_QUEUE_SIZE),
-		eventQueue_(MAX_QUEUE_SIZE),
+		maxAsyncWorkers_(maxAsyncWorkers),
+		asyncWorkers_(*this),
+		arrayBuffers_(),
+		snapshot_(),
+		snapshotOutput_(snapshotOutput),
+		codeCache_(),
+		jsonCache_(".json.bin"),
+		moduleResolver_(),
+		moduleSources_(),
+		mainWorker_(nullptr),
+		standbyWorkers_(),
+		isWorkerPoolActive_(false),
+		eventQueue_(MAX_QUEUE_SIZE, false, EventQueue::Channel::MPSC),
 		v8Platform_(v8::platform::NewDefaultPlatform()),
 		appConfig_(),
 		windowManager_(*this),
+		subscriptions_(),
+		subscribers_(),
+		coalescing_(),
 		isTerminating_(false)
 	{
 #ifdef _WINDOWS
@@ -119,12 +141,34 @@ namespace NativeJS
 		wc_.lpszClassName = WIN_CLASS_NAME.c_str();
 
 		RegisterClass(&wc_);
+#elif defined(__linux__)
+		// SIGINT/SIGTERM are read from a signalfd by the main loop, so they have to be blocked before any thread is spawned
+		sigset_t signals;
+		sigemptyset(&signals);
+		sigaddset(&signals, SIGINT);
+		sigaddset(&signals, SIGTERM);
+		pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+		logger().debug("Creating epoll instance...");
+		epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+		wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		signalFd_ = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+		isWakePending_.store(false, std::memory_order::release);
+
+		if (epollFd_ == -1 || wakeFd_ == -1 || signalFd_ == -1)
+			throw std::runtime_error("Could not create the main loop file descriptors!");
+
+		epoll_event ev = {};
+		ev.events = EPOLLIN;
+		ev.data.fd = wakeFd_;
+		epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &ev);
+		ev.data.fd = signalFd_;
+		epoll_ctl(epollFd_, EPOLL_CTL_ADD, signalFd_, &ev);
 #endif
 
 		logger().debug("Initializing Async Workers...");
 
-		for (size_t i = 0; i < 4; i++)
-			asyncWorkers_.emplace_back(new AsyncWorker(*this));
+		asyncWorkers_.init(maxAsyncWorkers_);
 
 		logger().debug("Initializing v8 Platform...");
 		v8::V8::InitializePlatform(v8Platform_.get());
@@ -142,6 +186,35 @@ namespace NativeJS
 		if (!v8::JSON::Parse(startupEnv_.context(), JS::string(startupEnv_, jsonString)).ToLocal(&config))
 			throw std::runtime_error("Could not parse app.json!");
 		appConfig_.load(startupEnv_, config.As<v8::Object>());
+		arrayBuffers_.setHugePages(appConfig_.hugePages);
+
+		if (snapshotOutput_.empty() && !appConfig_.snapshot.empty())
+		{
+			logger().debug("Loading v8 startup snapshot...");
+			if (!snapshot_.load(rootDir_ / appConfig_.snapshot))
+				logger().warn("Could not load the startup snapshot, the runtime is built on startup instead!");
+		}
+
+		if (!appConfig_.codeCache.empty())
+			codeCache_.setDirectory(rootDir_ / appConfig_.codeCache);
+
+		// the serialized JSON modules are always shared in memory, the directory only persists them
+		jsonCache_.setDirectory(appConfig_.jsonCache.empty() ? std::filesystem::path() : rootDir_ / appConfig_.jsonCache);
+
+		logger().debug("Scanning modules...");
+		moduleResolver_.initialize(rootDir_, appConfig_.resolve, appConfig_.watchModules);
+		// a watched file can be edited in place while a worker still uses its mapping
+		moduleSources_.setCopied(appConfig_.watchModules);
+
+#ifdef __linux__
+		if (moduleResolver_.watchFd() != -1)
+		{
+			epoll_event ev = {};
+			ev.events = EPOLLIN;
+			ev.data.fd = moduleResolver_.watchFd();
+			epoll_ctl(epollFd_, EPOLL_CTL_ADD, moduleResolver_.watchFd(), &ev);
+		}
+#endif
 	}
 
 	App::~App()
@@ -173,23 +246,22 @@ namespace NativeJS
 		logger().debug("Disposing v8 Platform...");
 		v8::V8::DisposePlatform();
 
-		for (AsyncWorker* worker : asyncWorkers_)
-			worker->terminate();
-
-		asyncCV_.notify_all();
-
-		for (AsyncWorker* worker : asyncWorkers_)
-			delete worker;
+		asyncWorkers_.terminate();
 
 #ifdef _WINDOWS
 		logger().debug("Unregistering Windows Class...");
 		UnregisterClass(WIN_CLASS_NAME.c_str(), GetModuleHandle(NULL));
+#elif defined(__linux__)
+		logger().debug("Closing epoll instance...");
+		close(signalFd_);
+		close(wakeFd_);
+		close(epollFd_);
 #endif
 
 		Logger::terminate();
 	}
 
-	Worker* App::createWorker(std::filesystem::path&& entry, Worker* parentWorker)
+	Worker* App::createWorker(std::filesystem::path&& entry, Worker* parentWorker, const HeapLimits* heapLimits)
 	{
 		std::filesystem::path p;
 
@@ -200,32 +272,65 @@ namespace NativeJS
 
 		p = p.lexically_normal();
 
-		size_t index = workers_.alloc(*this, std::move(p), parentWorker);
+		const HeapLimits& limits = heapLimits != nullptr ? *heapLimits : appConfig_.heap;
+
+		// the main worker is always created cold, the pool only pays off for apps that spawn workers
+		if (parentWorker != nullptr)
+		{
+			isWorkerPoolActive_ = true;
+
+			Worker* standby = takeStandbyWorker(limits);
+			if (standby != nullptr)
+			{
+				standby->bind(std::move(p), parentWorker);
+				return standby;
+			}
+		}
+
+		size_t index = workers_.alloc(*this, std::move(p), parentWorker, limits);
 		Worker* worker = workers_.at(index);
 		worker->index_ = index;
 		return worker;
 	}
 
-	Worker* App::createWorker(const std::filesystem::path& entry, Worker* parentWorker)
+	Worker* App::createWorker(const std::filesystem::path& entry, Worker* parentWorker, const HeapLimits* heapLimits)
 	{
-		std::filesystem::path p;
-
-		if (!entry.is_absolute())
-			p = rootDir_ / entry;
-		else
-			p = entry;
+		return createWorker(std::filesystem::path(entry), parentWorker, heapLimits);
+	}
 
-		p = p.lexically_normal();
+	Worker* App::takeStandbyWorker(const HeapLimits& heapLimits)
+	{
+		// the heap limits are fixed when the isolate is created, so a worker with its own limits can only use a standby worker with the same ones
+		auto it = std::find_if(standbyWorkers_.begin(), standbyWorkers_.end(), [&](Worker* worker) { return worker->heapLimits() == heapLimits; });
+		if (it == standbyWorkers_.end())
+			return nullptr;
 
-		size_t index = workers_.alloc(*this, p, parentWorker);
-		Worker* worker = workers_.at(index);
-		worker->index_ = index;
+		Worker* worker = *it;
+		standbyWorkers_.erase(it);
 		return worker;
 	}
 
+	void App::refillWorkerPool()
+	{
+		if (!isWorkerPoolActive_ || isTerminating_)
+			return;
+
+		while (standbyWorkers_.size() < appConfig_.workerPool)
+		{
+			size_t index = workers_.alloc(*this, appConfig_.heap);
+			Worker* worker = workers_.at(index);
+			worker->index_ = index;
+			standbyWorkers_.push_back(worker);
+		}
+	}
+
 	bool App::destroyWorker(Worker* worker)
 	{
 		assert(worker != nullptr);
+
+		subscriptions_.unsubscribeAll(worker);
+		windowManager_.unsubscribeAll(worker);
+
 		int exitCode = 0;
 		if (worker->terminate(exitCode))
 		{
@@ -238,57 +343,117 @@ namespace NativeJS
 
 	void App::emitEvent(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
 	{
-		NativeEvent* event = events_.create<NativeEvent>(OSEvent { hwnd, uMsg, wParam, lParam }, workers_.size());
-		workers_.forEach([&](Worker* worker)
+		const OSEvent osEvent = { hwnd, uMsg, wParam, lParam };
+		const bool isCoalescable = hwnd != nullptr && NativeEvent::isCoalescable(uMsg);
+
+		// while the previous event of the same kind is still pending in the queues it just takes over the newer state
+		if (isCoalescable)
+		{
+			for (NativeEvent* pending : coalescing_)
+			{
+				if (pending->event().hwnd == hwnd && pending->event().uMsg == uMsg && pending->coalesce(osEvent))
+					return;
+			}
+		}
+
+		subscribers_.clear();
+
+		Window* window = hwnd == nullptr ? nullptr : windowManager_.getWindow(hwnd);
+		if (window != nullptr)
+			window->subscriptions().collect(uMsg, subscribers_);
+		else
+			subscriptions_.collect(uMsg, subscribers_);
+
+		NativeEvent* event = events_.create<NativeEvent>(osEvent, subscribers_.size());
+
+		// without subscribers the event goes straight to the main thread's default handling
+		if (subscribers_.empty())
+		{
+			postEvent(event, true);
+			return;
+		}
+
+		if (isCoalescable)
+		{
+			std::erase_if(coalescing_, [&](NativeEvent* pending) { return pending->event().hwnd == hwnd && pending->event().uMsg == uMsg; });
+			coalescing_.emplace_back(event);
+		}
+
+		for (Worker* worker : subscribers_)
 		{
 			if (!worker->postEvent(event))
+			{
 				logger_.error("Could not post event!");
-		});
+				if (event->process([](const OSEvent&) { }))
+					postEvent(event, true);
+			}
+		}
 	}
 
 	bool App::postEvent(Event* event, bool onMainThread)
 	{
 		if (onMainThread)
 		{
-			if (eventQueue_.queue_.push(event))
+			if (eventQueue_.push(event))
 			{
 #ifdef _WINDOWS
 				PostThreadMessage(mainThreadID_, WM_USER, 0, 0);
+#elif defined(__linux__)
+				wakeMainThread();
 #endif
 				return true;
 			}
 			return false;
 		}
-		else if (asyncEventQueue_.push(event))
-		{
-			asyncCV_.notify_one();
-			return true;
-		}
-		return false;
+
+		// work of the same worker prefers the same AsyncWorker, so its queue stays warm and submitters rarely contend
+		size_t affinity = 0;
+		if (event->type() == Event::Type::Async)
+			affinity = event->as<AsyncEvent>().worker().index_;
+		else if (event->type() == Event::Type::Blocking)
+			affinity = event->as<BlockingEvent>().worker().index_;
+
+		return asyncWorkers_.submit(event, affinity);
 	}
 
-	bool App::getAsyncWork(Event*& event)
+	WindowManager& App::windowManager()
 	{
-		if (isTerminating_)
-		{
-			event = Event::getTerminateEvent();
-			return true;
-		}
+		return windowManager_;
+	}
 
-		if (asyncEventQueue_.pop(event))
-			return true;
+	ArrayBufferPool& App::arrayBufferPool()
+	{
+		return arrayBuffers_;
+	}
 
-		{
-			std::unique_lock lk(asyncMutex_);
-			asyncCV_.wait(lk, [&]() { return isTerminating_ || asyncEventQueue_.size() > 0; });
-		}
+	JS::Snapshot& App::snapshot()
+	{
+		return snapshot_;
+	}
 
-		return asyncEventQueue_.pop(event);
+	CodeCache& App::codeCache()
+	{
+		return codeCache_;
 	}
 
-	WindowManager& App::windowManager()
+	CodeCache& App::jsonCache()
 	{
-		return windowManager_;
+		return jsonCache_;
+	}
+
+	ModuleResolver& App::moduleResolver()
+	{
+		return moduleResolver_;
+	}
+
+	ModuleSources& App::moduleSources()
+	{
+		return moduleSources_;
+	}
+
+	EventSubscriptions& App::subscriptions()
+	{
+		return subscriptions_;
 	}
 
 	size_t App::getTickTimeout() const
@@ -319,23 +484,91 @@ namespace NativeJS
 		return appConfig_;
 	}
 
+	void App::processEvent(Event* event, bool& isRunning)
+	{
+		if (event->status() == Event::Status::Canceled)
+		{
+			logger_.debug("Event canceled!");
+			return;
+		}
+
+		switch (event->type())
+		{
+			case Event::Type::Native:
+			{
+				NativeEvent* e = static_cast<NativeEvent*>(event);
+				std::erase(coalescing_, e);
+				switch (e->event().uMsg)
+				{
+					case WM_QUIT:
+						isRunning = false;
+						break;
+					case WM_DESTROY:
+						windowManager_.destroy(e->event().hwnd);
+						if (windowManager_.getWindowCount() == 0)
+						{
+#ifdef _WINDOWS
+							PostQuitMessage(0);
+#else
+							emitEvent(nullptr, WM_QUIT, 0, 0);
+#endif
+						}
+						break;
+				}
+#ifdef _WINDOWS
+				const OSEvent& osEvent = e->event();
+				DefWindowProc(osEvent.hwnd, osEvent.uMsg, osEvent.wParam, osEvent.lParam);
+#endif
+				events_.remove(event);
+			}
+			break;
+			case Event::Type::Async:
+			{
+				AsyncEvent* e = static_cast<AsyncEvent*>(event);
+				e->work_(e);
+				e->worker_.postEvent(e);
+			}
+			break;
+			case Event::Type::Blocking:
+			{
+				BlockingEvent* e = static_cast<BlockingEvent*>(event);
+				Worker& worker = e->worker_;
+				e->work_(e);
+				{
+					std::lock_guard lk(worker.blockingWorkMutex_);
+					e->done_.store(true, std::memory_order::release);
+				}
+				worker.blockingWorkCv_.notify_all();
+			}
+			break;
+		}
+	}
 
 #ifdef _WINDOWS
 	void App::run()
 	{
-		mainWorker_ = createWorker(appConfig_.entry.file);
+		if (!snapshotOutput_.empty())
+		{
+			exitCode_ = JS::Snapshot::build(*this, snapshotOutput_) ? 0 : 1;
+			return;
+		}
+
+		mainWorker_ = createWorker(appConfig_.entry.file, nullptr, &appConfig_.entry.heap);
 
 		MSG msg = { };
 		bool isRunning = true;
 
-		Event* event;
-
-		const size_t wait = tickTimeout_ == 0 ? INFINITE : tickTimeout_;
+		Event* events[MAX_EVENT_BATCH];
 
 		while (isRunning)
 		{
+			refillWorkerPool();
+
 			if (eventQueue_.size() == 0 && PeekMessage(&msg, NULL, 0, 0, PM_NOREMOVE) == 0)
-				MsgWaitForMultipleObjects(0, NULL, FALSE, INFINITE, QS_ALLINPUT);
+			{
+				const DWORD wait = tickTimeout_ == 0 ? INFINITE : static_cast<DWORD>(tickTimeout_);
+				MsgWaitForMultipleObjects(0, NULL, FALSE, wait, QS_ALLINPUT);
+			}
 
 			if (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE) > 0)
 			{
@@ -351,127 +584,10 @@ namespace NativeJS
 				}
 			}
 
-			if (eventQueue_.tryPopEvent(event))
-			{
-				if (event->status() != Event::Status::Canceled)
-				{
-					switch (event->type())
-					{
-						case Event::Type::Native:
-						{
-							NativeEvent* e = static_cast<NativeEvent*>(event);
-							OSEvent osEvent = e->event();
-							switch (e->event().uMsg)
-							{
-								case WM_QUIT:
-									isRunning = false;
-									break;
-								case WM_DESTROY:
-									windowManager_.destroy(e->event().hwnd);
-									if (windowManager_.getWindowCount() == 0)
-									{
-										PostQuitMessage(0);
-									}
-									break;
-							}
-							DefWindowProc(osEvent.hwnd, osEvent.uMsg, osEvent.wParam, osEvent.lParam);
-							events_.remove(event);
-						}
-						break;
-						case Event::Type::Async:
-						{
-							AsyncEvent* e = static_cast<AsyncEvent*>(event);
-							e->work_(e);
-							e->worker_.postEvent(e);
-						}
-						break;
-						case Event::Type::Blocking:
-						{
-							BlockingEvent* e = static_cast<BlockingEvent*>(event);
-							e->work_(e);
-							e->done_.store(true, std::memory_order::release);
-							e->worker_.blockingWorkCv_.notify_all();
-						}
-						break;
-						case Event::Type::Timeout:
-						{
-							TimeoutEvent* e = static_cast<TimeoutEvent*>(event);
-							if (e->type == TimeoutEvent::Type::CANCEL)
-							{
-								if (!timeoutIDsToPtrs_.contains(e->timeoutIndex))
-								{
-									printf("Could not get timer with id %zu\n", e->timeoutIndex);
-								}
-								else
-								{
-									UINT_PTR timerID = timeoutIDsToPtrs_.at(e->timeoutIndex);
-									KillTimer(NULL, timerID);
-									timeoutIDsToPtrs_.erase(e->timeoutIndex);
-									timeoutEvents_.erase(timerID);
-								}
-							}
-							else if (e->type == TimeoutEvent::Type::RESET)
-							{
-
-							}
-							else
-							{
-								const size_t r = e->resolveTime.count();
-								const size_t now = Utils::now<std::chrono::milliseconds>().count();
-								if (now <= r)
-								{
-									static UINT_PTR timerCounter = 0;
-									UINT_PTR timerID = SetTimer(nullptr, ++timerCounter, r - now, App::timerProc);
-									if (timerID == 0)
-									{
-										puts("Could not create timer!");
-									}
-									else
-									{
-										puts("got timeout event");
-
-										timeoutEvents_.emplace(timerID, e);
-										timeoutIDsToPtrs_.emplace(e->timeoutIndex, timerID);
-									}
-								}
-								else
-								{
-									puts("resolve directly :D");
-								}
-							}
-
-						}
-						break;
-					}
-				}
-				else
-				{
-					logger_.debug("Event canceled!");
-				}
-			}
-		}
-	}
-
-	void CALLBACK App::timerProc(HWND hwnd, UINT uMsg, UINT_PTR intPtr, DWORD index)
-	{
-		assert(currentInstance_);
-
-		NativeJS::App& app = *currentInstance_;
-
-		if (app.timeoutEvents_.contains(intPtr))
-		{
-			TimeoutEvent* e = app.timeoutEvents_.at(intPtr);
-
-			e->env.worker().postEvent(e);
-
-			if (!e->loop)
-			{
-				KillTimer(hwnd, intPtr);
-			}
-			else
-			{
-				SetTimer(hwnd, intPtr, e->duration, App::timerProc);
-			}
+			// the events popped along with a quit are still processed, they are off the queue and a worker may wait on them
+			const size_t count = eventQueue_.tryPopBatch(events);
+			for (size_t i = 0; i < count; i++)
+				processEvent(events[i], isRunning);
 		}
 	}
 
@@ -485,6 +601,8 @@ namespace NativeJS
 		{
 			case WM_CLOSE:
 			case WM_MOUSEMOVE:
+			case WM_MOUSEWHEEL:
+			case WM_SIZE:
 			case WM_DESTROY:
 			{
 				app.emitEvent(hwnd, uMsg, wParam, lParam);
@@ -503,5 +621,76 @@ namespace NativeJS
 
 		return DefWindowProc(hwnd, uMsg, wParam, lParam);
 	}
-}
+#elif defined(__linux__)
+	void App::run()
+	{
+		if (!snapshotOutput_.empty())
+		{
+			exitCode_ = JS::Snapshot::build(*this, snapshotOutput_) ? 0 : 1;
+			return;
+		}
+
+		mainWorker_ = createWorker(appConfig_.entry.file, nullptr, &appConfig_.entry.heap);
+
+		epoll_event epollEvents[MAX_EPOLL_EVENTS];
+		bool isRunning = true;
+
+		Event* events[MAX_EVENT_BATCH];
+
+		while (isRunning)
+		{
+			refillWorkerPool();
+
+			const int wait = eventQueue_.size() != 0 ? 0 : tickTimeout_ == 0 ? -1 : static_cast<int>(tickTimeout_);
+			const int count = epoll_wait(epollFd_, epollEvents, static_cast<int>(MAX_EPOLL_EVENTS), wait);
+
+			if (count == -1 && errno != EINTR)
+			{
+				logger_.error("epoll_wait failed with errno ", errno);
+				break;
+			}
+
+			for (int i = 0; i < count; i++)
+			{
+				const int fd = epollEvents[i].data.fd;
+				if (fd == wakeFd_)
+				{
+					uint64_t value = 0;
+					read(wakeFd_, &value, sizeof(value));
+					// everything posted before this point is drained below, everything after it has to wake us again
+					isWakePending_.exchange(false, std::memory_order::acq_rel);
+				}
+				else if (fd == signalFd_)
+				{
+					signalfd_siginfo info;
+					read(signalFd_, &info, sizeof(info));
+					emitEvent(nullptr, WM_QUIT, 0, 0);
+				}
+				else if (fd == moduleResolver_.watchFd())
+				{
+					moduleResolver_.processWatchEvents();
+					moduleSources_.clear();
+				}
+			}
+
+			size_t popped = 0;
+			while (isRunning && (popped = eventQueue_.tryPopBatch(events)) > 0)
+			{
+				// the events popped along with a quit are still processed, they are off the queue and a worker may wait on them
+				for (size_t i = 0; i < popped; i++)
+					processEvent(events[i], isRunning);
+			}
+		}
+	}
+
+	void App::wakeMainThread()
+	{
+		// only the first post of a batch writes to the eventfd, the main loop drains the whole queue per wakeup
+		if (!isWakePending_.exchange(true, std::memory_order::acq_rel))
+		{
+			const uint64_t value = 1;
+			write(wakeFd_, &value, sizeof(value));
+		}
+	}
 #endif
+}
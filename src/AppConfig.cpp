@@ -15,6 +15,11 @@ namespace NativeJS
 
 		Logger& logger = env.app().logger();
 
+		v8::Local<v8::Value> heapObj;
+		if (JS::getFromObject(env, obj, "heap", heapObj))
+			heap.load(env, heapObj);
+		entry.heap = heap;
+
 		v8::Local<v8::Value> entryObj = JS::getFromObject(env, obj, "entry").ToLocalChecked();
 		if (entryObj.IsEmpty())
 		{
@@ -40,6 +45,9 @@ namespace NativeJS
 					JS::parseString(env, exportsName, entry.exportName);
 				else
 					entry.exportName = "default";
+
+				if (JS::getFromObject(env, entryObj, "heap", heapObj))
+					entry.heap.load(env, heapObj);
 			}
 
 		}
@@ -56,6 +64,40 @@ namespace NativeJS
 				JS::parseString(env, resolvesArr->Get(env.context(), i).ToLocalChecked(), resolve[i]);
 		}
 
+		v8::Local<v8::Value> watchModulesVal;
+		if (JS::getFromObject(env, obj, "watchModules", watchModulesVal) && watchModulesVal->IsBoolean())
+			watchModules = watchModulesVal.As<v8::Boolean>()->Value();
+
+		v8::Local<v8::Value> hugePagesVal;
+		if (JS::getFromObject(env, obj, "hugePages", hugePagesVal) && hugePagesVal->IsBoolean())
+			hugePages = hugePagesVal.As<v8::Boolean>()->Value();
+
+		v8::Local<v8::Value> workerPoolVal;
+		if (JS::getFromObject(env, obj, "workerPool", workerPoolVal))
+			JS::parseNumber(env.context(), workerPoolVal, workerPool);
+
+		v8::Local<v8::Value> snapshotVal;
+		if (JS::getFromObject(env, obj, "snapshot", snapshotVal) && snapshotVal->IsString())
+			JS::parseString(env, snapshotVal, snapshot);
+
+		v8::Local<v8::Value> codeCacheVal;
+		if (JS::getFromObject(env, obj, "codeCache", codeCacheVal))
+		{
+			if (codeCacheVal->IsString())
+				JS::parseString(env, codeCacheVal, codeCache);
+			else if (codeCacheVal->IsFalse())
+				codeCache.clear();
+		}
+
+		v8::Local<v8::Value> jsonCacheVal;
+		if (JS::getFromObject(env, obj, "jsonCache", jsonCacheVal))
+		{
+			if (jsonCacheVal->IsString())
+				JS::parseString(env, jsonCacheVal, jsonCache);
+			else if (jsonCacheVal->IsFalse())
+				jsonCache.clear();
+		}
+
 		isLoaded_ = true;
 	}
 }
\ No newline at end of file
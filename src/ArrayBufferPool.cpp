@@ -0,0 +1,204 @@
+#include "framework.hpp"
+#include "ArrayBufferPool.hpp"
+
+namespace NativeJS
+{
+	namespace
+	{
+		size_t pageSize()
+		{
+#ifdef _WINDOWS
+			static const size_t size = []()
+			{
+				SYSTEM_INFO info;
+				GetSystemInfo(&info);
+				return static_cast<size_t>(info.dwPageSize);
+			}();
+#else
+			static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+			return size;
+		}
+
+		inline size_t roundUp(size_t length, size_t alignment)
+		{
+			return (length + alignment - 1) & ~(alignment - 1);
+		}
+	}
+
+	ArrayBufferPool::SizeClass::SizeClass(size_t blockSize) :
+		blockSize(blockSize),
+		capacity(ARRAY_BUFFER_CLASS_RESERVE / blockSize),
+		base(nullptr),
+		carved(0),
+		freeList(0)
+	{
+		// only address space is reserved, pages are backed on first touch
+#ifdef _WINDOWS
+		base = static_cast<char*>(VirtualAlloc(nullptr, ARRAY_BUFFER_CLASS_RESERVE, MEM_RESERVE, PAGE_NOACCESS));
+#else
+		void* data = mmap(nullptr, ARRAY_BUFFER_CLASS_RESERVE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		base = data == MAP_FAILED ? nullptr : static_cast<char*>(data);
+#endif
+		if (base == nullptr)
+			carved.store(capacity, std::memory_order::relaxed);
+	}
+
+	ArrayBufferPool::SizeClass::~SizeClass()
+	{
+		if (base == nullptr)
+			return;
+#ifdef _WINDOWS
+		VirtualFree(base, 0, MEM_RELEASE);
+#else
+		munmap(base, ARRAY_BUFFER_CLASS_RESERVE);
+#endif
+	}
+
+	void* ArrayBufferPool::SizeClass::pop()
+	{
+		uint64_t top = freeList.load(std::memory_order::acquire);
+		for (;;)
+		{
+			const uint32_t index = static_cast<uint32_t>(top);
+			if (index == 0)
+				return nullptr;
+
+			char* data = block(index - 1);
+			// the block may be popped and written concurrently, a stale next is caught by the tag
+			const uint32_t next = std::atomic_ref<uint32_t>(*reinterpret_cast<uint32_t*>(data)).load(std::memory_order::relaxed);
+			const uint64_t tag = (top >> 32) + 1;
+			if (freeList.compare_exchange_weak(top, (tag << 32) | next, std::memory_order::acq_rel, std::memory_order::acquire))
+				return data;
+		}
+	}
+
+	void ArrayBufferPool::SizeClass::push(void* data)
+	{
+		const uint32_t index = static_cast<uint32_t>((static_cast<char*>(data) - base) / blockSize) + 1;
+		std::atomic_ref<uint32_t> next(*static_cast<uint32_t*>(data));
+
+		uint64_t top = freeList.load(std::memory_order::relaxed);
+		for (;;)
+		{
+			next.store(static_cast<uint32_t>(top), std::memory_order::relaxed);
+			const uint64_t tag = (top >> 32) + 1;
+			if (freeList.compare_exchange_weak(top, (tag << 32) | index, std::memory_order::release, std::memory_order::relaxed))
+				return;
+		}
+	}
+
+	ArrayBufferPool::ArrayBufferPool() :
+		classes_(),
+		useHugePages_(false)
+	{
+		for (size_t i = 0; i < CLASS_COUNT; i++)
+			classes_[i] = new SizeClass(static_cast<size_t>(1) << (ARRAY_BUFFER_MIN_CLASS_SHIFT + i));
+	}
+
+	ArrayBufferPool::~ArrayBufferPool()
+	{
+		for (SizeClass* sizeClass : classes_)
+			delete sizeClass;
+	}
+
+	size_t ArrayBufferPool::classOf(size_t length)
+	{
+		if (length <= (static_cast<size_t>(1) << ARRAY_BUFFER_MIN_CLASS_SHIFT))
+			return 0;
+
+		const size_t shift = std::bit_width(length - 1);
+		return shift > ARRAY_BUFFER_MAX_CLASS_SHIFT ? CLASS_COUNT : shift - ARRAY_BUFFER_MIN_CLASS_SHIFT;
+	}
+
+	void* ArrayBufferPool::alloc(size_t length, bool zeroed)
+	{
+		const size_t i = classOf(length);
+		if (i == CLASS_COUNT)
+			return mapPages(length);
+
+		SizeClass& sizeClass = *classes_[i];
+
+		void* data = sizeClass.pop();
+		if (data != nullptr)
+		{
+			// only the part the buffer can see has to be cleared, the rest of the block is never read
+			if (zeroed)
+				memset(data, 0, length);
+			return data;
+		}
+
+		const size_t index = sizeClass.carved.fetch_add(1, std::memory_order::relaxed);
+		if (index >= sizeClass.capacity)
+		{
+			sizeClass.carved.store(sizeClass.capacity, std::memory_order::relaxed);
+			return mapPages(length);
+		}
+
+		data = sizeClass.block(static_cast<uint32_t>(index));
+#ifdef _WINDOWS
+		if (VirtualAlloc(data, sizeClass.blockSize, MEM_COMMIT, PAGE_READWRITE) == nullptr)
+			return nullptr;
+#endif
+		return data;
+	}
+
+	void ArrayBufferPool::free(void* data, size_t length)
+	{
+		if (data == nullptr)
+			return;
+
+		const size_t i = classOf(length);
+		if (i < CLASS_COUNT && classes_[i]->owns(data))
+			classes_[i]->push(data);
+		else
+			unmapPages(data, length);
+	}
+
+	size_t ArrayBufferPool::pooledBytes() const
+	{
+		size_t bytes = 0;
+		for (const SizeClass* sizeClass : classes_)
+			bytes += std::min(sizeClass->carved.load(std::memory_order::relaxed), sizeClass->capacity) * sizeClass->blockSize;
+		return bytes;
+	}
+
+	void* ArrayBufferPool::mapPages(size_t length)
+	{
+		// fresh pages are zeroed by the OS, so direct mappings never need clearing
+		const bool useHugePages = length >= HUGE_PAGE_SIZE && useHugePages_.load(std::memory_order::relaxed);
+		length = roundUp(std::max<size_t>(length, 1), pageSize());
+
+#ifdef _WINDOWS
+		if (useHugePages)
+		{
+			// large pages need SeLockMemoryPrivilege, without it the allocation falls back to normal pages
+			const size_t largePage = GetLargePageMinimum();
+			if (largePage != 0)
+			{
+				void* data = VirtualAlloc(nullptr, roundUp(length, largePage), MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+				if (data != nullptr)
+					return data;
+			}
+		}
+		return VirtualAlloc(nullptr, length, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+		void* data = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (data == MAP_FAILED)
+			return nullptr;
+		// transparent huge pages keep the mapping size unchanged, so free does not need to know how it was backed
+		if (useHugePages)
+			madvise(data, length, MADV_HUGEPAGE);
+		return data;
+#endif
+	}
+
+	void ArrayBufferPool::unmapPages(void* data, size_t length)
+	{
+#ifdef _WINDOWS
+		VirtualFree(data, 0, MEM_RELEASE);
+#else
+		munmap(data, roundUp(std::max<size_t>(length, 1), pageSize()));
+#endif
+	}
+}
@@ -1,5 +1,6 @@
 #include "framework.hpp"
 #include "AsyncWorker.hpp"
+#include "AsyncWorkerPool.hpp"
 #include "js/Env.hpp"
 #include "Event.hpp"
 #include "constants.hpp"
@@ -9,13 +10,15 @@
 
 namespace NativeJS
 {
-	AsyncWorker::AsyncWorker(App& app) :
-		app_(app),
+	AsyncWorker::AsyncWorker(AsyncWorkerPool& pool, size_t index) :
+		pool_(pool),
+		index_(index),
+		queue_(MAX_QUEUE_SIZE),
 		mutex_(),
 		cv_(),
-		thread_([&]() { returnCode_ = entry(); }),
 		returnCode_(0),
-		isRunning_(false)
+		isRunning_(false),
+		thread_([&]() { returnCode_ = entry(); })
 	{
 		std::unique_lock lk(mutex_);
 		cv_.wait(lk, [&]() { return isRunning_.load(std::memory_order::acquire); });
@@ -26,26 +29,21 @@ namespace NativeJS
 		if (thread_.joinable())
 			thread_.join();
 
-		app_.logger().info("AsyncWorker exited with code ", returnCode_);
-	}
-
-	void AsyncWorker::terminate()
-	{
-		isRunning_.store(false, std::memory_order::release);
+		pool_.app_.logger().info("AsyncWorker exited with code ", returnCode_);
 	}
 
 	int AsyncWorker::entry()
 	{
-		isRunning_.store(true, std::memory_order::release);
+		{
+			std::unique_lock lk(mutex_);
+			isRunning_.store(true, std::memory_order::release);
+		}
 		cv_.notify_all();
 
 		Event* event = nullptr;
 
-		while (app_.getAsyncWork(event))
+		while (pool_.getWork(*this, event))
 		{
-			if (!isRunning_.load(std::memory_order::acquire))
-				break;
-
 			if (event->type() == Event::Type::Async)
 			{
 				AsyncEvent& e = static_cast<AsyncEvent&>(*event);
@@ -55,12 +53,19 @@ namespace NativeJS
 			else if(event->type() == Event::Type::Blocking)
 			{
 				BlockingEvent& e = static_cast<BlockingEvent&>(*event);
+				// the event may be removed as soon as it is done
+				Worker& worker = e.worker();
 				e.work_(std::addressof(e));
-				e.done_.store(true, std::memory_order::release);
-				e.worker().blockingWorkCv_.notify_all();
+				{
+					std::lock_guard lk(worker.blockingWorkMutex_);
+					e.done_.store(true, std::memory_order::release);
+				}
+				worker.blockingWorkCv_.notify_all();
 			}
 		}
 
+		isRunning_.store(false, std::memory_order::release);
+
 		return 0;
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,136 @@
+#include "framework.hpp"
+#include "AsyncWorkerPool.hpp"
+#include "AsyncWorker.hpp"
+#include "App.hpp"
+#include "constants.hpp"
+
+namespace NativeJS
+{
+	AsyncWorkerPool::AsyncWorkerPool(App& app) :
+		app_(app),
+		workers_(),
+		size_(0),
+		overflowMutex_(),
+		overflow_(),
+		overflowSize_(0),
+		signal_(0),
+		sleepers_(0),
+		isTerminating_(false)
+	{
+
+	}
+
+	AsyncWorkerPool::~AsyncWorkerPool()
+	{
+		terminate();
+	}
+
+	void AsyncWorkerPool::init(size_t size)
+	{
+		assert(workers_.empty());
+
+		size = std::max<size_t>(size, 1);
+
+		// the vector is never resized again, so running AsyncWorkers can index it while the others are spawned
+		workers_.resize(size, nullptr);
+
+		for (size_t i = 0; i < size; i++)
+		{
+			workers_[i] = new AsyncWorker(*this, i);
+			size_.store(i + 1, std::memory_order::release);
+		}
+	}
+
+	void AsyncWorkerPool::terminate()
+	{
+		if (isTerminating_.exchange(true, std::memory_order::acq_rel))
+			return;
+
+		signal_.increment();
+		signal_.wakeAll();
+
+		for (AsyncWorker* worker : workers_)
+			delete worker;
+
+		workers_.clear();
+		size_.store(0, std::memory_order::release);
+	}
+
+	bool AsyncWorkerPool::submit(Event* event, size_t affinity)
+	{
+		const size_t count = size();
+		if (count == 0)
+			return false;
+
+		bool isQueued = false;
+		for (size_t i = 0; i < count && !isQueued; i++)
+			isQueued = workers_[(affinity + i) % count]->queue_.push(event);
+
+		if (!isQueued)
+		{
+			std::lock_guard lock(overflowMutex_);
+			overflow_.emplace_back(event);
+			overflowSize_.fetch_add(1, std::memory_order::release);
+		}
+
+		// pairs with the sleeper registration in getWork
+		signal_.increment();
+		if (sleepers_.load(std::memory_order::seq_cst) > 0)
+			signal_.wakeOne();
+		return true;
+	}
+
+	bool AsyncWorkerPool::tryGetWork(AsyncWorker& worker, Event*& event)
+	{
+		if (worker.queue_.pop(event))
+			return true;
+
+		const size_t count = size();
+		for (size_t i = 1; i < count; i++)
+		{
+			if (workers_[(worker.index_ + i) % count]->queue_.pop(event))
+				return true;
+		}
+
+		if (overflowSize_.load(std::memory_order::acquire) == 0)
+			return false;
+
+		std::lock_guard lock(overflowMutex_);
+		if (overflow_.empty())
+			return false;
+
+		event = overflow_.front();
+		overflow_.pop_front();
+		overflowSize_.fetch_sub(1, std::memory_order::release);
+		return true;
+	}
+
+	bool AsyncWorkerPool::getWork(AsyncWorker& worker, Event*& event)
+	{
+		while (!isTerminating_.load(std::memory_order::acquire))
+		{
+			for (size_t i = 0; i < EVENT_QUEUE_SPIN_COUNT; i++)
+			{
+				if (tryGetWork(worker, event))
+					return true;
+				Futex::pause();
+			}
+
+			const uint32_t signal = signal_.load();
+			sleepers_.fetch_add(1, std::memory_order::seq_cst);
+
+			if (tryGetWork(worker, event))
+			{
+				sleepers_.fetch_sub(1, std::memory_order::relaxed);
+				return true;
+			}
+
+			if (!isTerminating_.load(std::memory_order::acquire))
+				signal_.wait(signal);
+
+			sleepers_.fetch_sub(1, std::memory_order::relaxed);
+		}
+
+		return false;
+	}
+}
@@ -0,0 +1,93 @@
+#include "framework.hpp"
+#include "CodeCache.hpp"
+
+namespace NativeJS
+{
+	CodeCache::CodeCache(const char* extension) :
+		extension_(extension),
+		directory_(),
+		isEnabled_(false),
+		versionTag_(0),
+		mutex_(),
+		entries_()
+	{ }
+
+	void CodeCache::setDirectory(const std::filesystem::path& directory)
+	{
+		directory_ = directory;
+		isEnabled_ = true;
+		versionTag_ = v8::ScriptCompiler::CachedDataVersionTag();
+
+		std::error_code error;
+		if (!directory_.empty())
+			std::filesystem::create_directories(directory_, error);
+	}
+
+	CodeCache::Data CodeCache::get(Hash sourceHash)
+	{
+		if (!isEnabled())
+			return nullptr;
+
+		{
+			std::lock_guard lock(mutex_);
+			auto it = entries_.find(sourceHash);
+			if (it != entries_.end())
+				return it->second;
+		}
+
+		// read outside of the lock, two workers loading the same module at once just read the file twice
+		Data data = nullptr;
+		std::ifstream is;
+		if (!directory_.empty())
+			is.open(pathOf(sourceHash), std::ios::binary);
+		if (is.is_open())
+		{
+			std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+			if (!bytes.empty())
+				data = std::make_shared<const std::vector<uint8_t>>(std::move(bytes));
+		}
+
+		std::lock_guard lock(mutex_);
+		return entries_.try_emplace(sourceHash, std::move(data)).first->second;
+	}
+
+	CodeCache::Data CodeCache::put(Hash sourceHash, std::vector<uint8_t>&& bytes)
+	{
+		if (!isEnabled() || bytes.empty())
+			return nullptr;
+
+		Data data = std::make_shared<const std::vector<uint8_t>>(std::move(bytes));
+
+		{
+			std::lock_guard lock(mutex_);
+			entries_.insert_or_assign(sourceHash, data);
+		}
+
+		if (directory_.empty())
+			return data;
+
+		// written next to the target and renamed over it, so no reader ever sees a partial file
+		const std::filesystem::path path = pathOf(sourceHash);
+		std::filesystem::path tmpPath = path;
+		tmpPath += "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+
+		std::ofstream os(tmpPath, std::ios::binary | std::ios::trunc);
+		os.write(reinterpret_cast<const char*>(data->data()), static_cast<std::streamsize>(data->size()));
+		os.close();
+
+		std::error_code error;
+		if (os)
+			std::filesystem::rename(tmpPath, path, error);
+		if (!os || error)
+			std::filesystem::remove(tmpPath, error);
+
+		return data;
+	}
+
+	std::filesystem::path CodeCache::pathOf(Hash sourceHash) const
+	{
+		char name[48] = {};
+		snprintf(name, sizeof(name), "%016llx-%08x", static_cast<unsigned long long>(sourceHash), versionTag_);
+		return directory_ / (name + extension_);
+	}
+}
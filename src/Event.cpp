@@ -1,6 +1,7 @@
 #include "framework.hpp"
 #include "Event.hpp"
 #include "Worker.hpp"
+#include "constants.hpp"
 #include "js/Env.hpp"
 
 namespace NativeJS
@@ -10,7 +11,11 @@ namespace NativeJS
 	Event::Event(Event::Type type, void* data) :
 		type_(type),
 		status_(Status::Pending),
-		data_(data)
+		data_(data),
+		allocator_(nullptr),
+		prevLive_(nullptr),
+		nextLive_(nullptr),
+		nextRemoved_(nullptr)
 	{
 
 	}
@@ -54,6 +59,12 @@ namespace NativeJS
 		promiseResolver_.Get(env.isolate())->Resolve(env.context(), val.IsEmpty() ? v8::Undefined(env.isolate()).As<v8::Value>() : val).ToChecked();
 	}
 
+	void WorkEvent::rejectPromise(v8::Local<v8::Value> reason) const
+	{
+		const JS::Env& env = worker_.env();
+		promiseResolver_.Get(env.isolate())->Reject(env.context(), reason).ToChecked();
+	}
+
 	v8::Local<v8::Promise> WorkEvent::promise() const
 	{
 		return promiseResolver_.Get(worker_.env().isolate())->GetPromise();
@@ -64,7 +75,8 @@ namespace NativeJS
 		worker_(worker),
 		work_(work),
 		resolver_(resolver),
-		promiseResolver_(worker.env().isolate(), v8::Promise::Resolver::New(worker.env().context()).ToLocalChecked())
+		promiseResolver_(worker.env().isolate(), v8::Promise::Resolver::New(worker.env().context()).ToLocalChecked()),
+		task_()
 	{ }
 
 	WorkEvent::~WorkEvent() { }
@@ -100,10 +112,24 @@ namespace NativeJS
 		promiseResolver_.Get(sender_->env().isolate())->Resolve(sender_->env().context(), v8::Undefined(sender_->env().isolate()));
 	}
 
+	void MessageEvent::rejectPromise(v8::Local<v8::Value> reason) const
+	{
+		promiseResolver_.Get(sender_->env().isolate())->Reject(sender_->env().context(), reason);
+	}
+
+	bool NativeEvent::isCoalescable(UINT uMsg)
+	{
+		return uMsg == WM_MOUSEMOVE || uMsg == WM_SIZE || uMsg == WM_MOUSEWHEEL;
+	}
+
 	NativeEvent::NativeEvent(const OSEvent& osEvent, size_t sendCount) :
 		Event(Event::Type::Native),
 		nativeEvent_(osEvent),
-		sendCount_(sendCount)
+		sendCount_(sendCount),
+		finishCount_(),
+		mutex_(),
+		isSealed_(false),
+		samples_()
 	{ }
 
 	NativeEvent::~NativeEvent() { }
@@ -113,26 +139,27 @@ namespace NativeJS
 		return nativeEvent_;
 	}
 
-
-	TimeoutEvent::TimeoutEvent(const JS::Env& env, const size_t timeoutIndex, Type type) :
-		Event(Event::Type::Timeout),
-		type(type),
-		env(env),
-		timeoutIndex(timeoutIndex),
-		duration(0),
-		resolveTime(0),
-		loop(false)
+	bool NativeEvent::coalesce(const OSEvent& osEvent)
 	{
-		assert(type != Type::INIT);
-	}
+		std::unique_lock lk(mutex_);
 
-	TimeoutEvent::TimeoutEvent(const JS::Env& env, const size_t timeoutIndex, const std::chrono::milliseconds resolveTime, const size_t duration, const bool loop) :
-		Event(Event::Type::Timeout),
-		env(env),
-		timeoutIndex(timeoutIndex),
-		resolveTime(resolveTime),
-		duration(duration),
-		loop(loop),
-		type(Type::INIT)
-	{ }
+		if (isSealed_)
+			return false;
+
+		if (samples_.size() == MAX_COALESCED_SAMPLES)
+			samples_.erase(samples_.begin());
+		samples_.emplace_back(nativeEvent_);
+
+		OSEvent next = osEvent;
+
+		// the wheel delta lives in the high word of wParam, a merged scroll has to cover all of the merged deltas
+		if (next.uMsg == WM_MOUSEWHEEL)
+		{
+			const int delta = static_cast<short>((nativeEvent_.wParam >> 16) & 0xFFFF) + static_cast<short>((next.wParam >> 16) & 0xFFFF);
+			next.wParam = (next.wParam & 0xFFFF) | (static_cast<WPARAM>(static_cast<unsigned short>(std::clamp(delta, -32768, 32767))) << 16);
+		}
+
+		nativeEvent_ = next;
+		return true;
+	}
 }
\ No newline at end of file
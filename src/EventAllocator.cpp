@@ -3,13 +3,115 @@
 
 namespace NativeJS
 {
-	EventAllocator::EventAllocator()
+	EventAllocator::EventAllocator() :
+		pools_(),
+		live_(nullptr),
+		removed_(nullptr),
+		size_(0),
+		ownerThread_(std::this_thread::get_id())
 	{
 
 	}
 
+	EventAllocator::~EventAllocator()
+	{
+		reclaim();
+
+		while (live_ != nullptr)
+		{
+			Event* event = live_;
+			unlink(event);
+			destroy(event);
+		}
+	}
+
+	void EventAllocator::bindToCurrentThread()
+	{
+		ownerThread_ = std::this_thread::get_id();
+	}
+
 	bool EventAllocator::remove(Event* e)
 	{
-		return list_.free(e->index_);
+		if (e->allocator_ != this)
+			return false;
+
+		e->allocator_ = nullptr;
+		size_.fetch_sub(1, std::memory_order::release);
+
+		if (std::this_thread::get_id() == ownerThread_)
+		{
+			unlink(e);
+			destroy(e);
+			return true;
+		}
+
+		// the owner unlinks and destroys it, so the event never leaves the thread that created it mid-use
+		Event* head = removed_.load(std::memory_order::relaxed);
+		do
+		{
+			e->nextRemoved_ = head;
+		} while (!removed_.compare_exchange_weak(head, e, std::memory_order::release, std::memory_order::relaxed));
+
+		return true;
+	}
+
+	void EventAllocator::link(Event* event)
+	{
+		event->prevLive_ = nullptr;
+		event->nextLive_ = live_;
+		if (live_ != nullptr)
+			live_->prevLive_ = event;
+		live_ = event;
+	}
+
+	void EventAllocator::unlink(Event* event)
+	{
+		if (event->prevLive_ != nullptr)
+			event->prevLive_->nextLive_ = event->nextLive_;
+		else
+			live_ = event->nextLive_;
+
+		if (event->nextLive_ != nullptr)
+			event->nextLive_->prevLive_ = event->prevLive_;
+
+		event->prevLive_ = nullptr;
+		event->nextLive_ = nullptr;
+	}
+
+	void EventAllocator::destroy(Event* event)
+	{
+		switch (event->type())
+		{
+			case Event::Type::Async:
+				pool<AsyncEvent>().free(static_cast<AsyncEvent*>(event));
+				break;
+			case Event::Type::Blocking:
+				pool<BlockingEvent>().free(static_cast<BlockingEvent*>(event));
+				break;
+			case Event::Type::Message:
+				pool<MessageEvent>().free(static_cast<MessageEvent*>(event));
+				break;
+			case Event::Type::Native:
+				pool<NativeEvent>().free(static_cast<NativeEvent*>(event));
+				break;
+			default:
+				assert(false && "Event type without a pool!");
+				break;
+		}
+	}
+
+	void EventAllocator::reclaim()
+	{
+		if (removed_.load(std::memory_order::relaxed) == nullptr)
+			return;
+
+		Event* event = removed_.exchange(nullptr, std::memory_order::acquire);
+		while (event != nullptr)
+		{
+			Event* next = event->nextRemoved_;
+			unlink(event);
+			destroy(event);
+			event = next;
+		}
 	}
-}
\ No newline at end of file
+}
@@ -1,25 +1,67 @@
 #include "framework.hpp"
 #include "EventQueue.hpp"
+#include "constants.hpp"
 
 namespace NativeJS
 {
-	EventQueue::EventQueue(size_t capacity) :
-		queue_(capacity),
-		threadID_(std::this_thread::get_id())
+	EventQueue::Lane EventQueue::laneOf(const Event* event)
 	{
+		switch (event->type())
+		{
+			case Event::Type::Async:
+			case Event::Type::Blocking:
+				return Lane::Completion;
+			case Event::Type::Message:
+				return Lane::Message;
+			default:
+				// native input and terminate requests must not wait behind background work
+				return Lane::Input;
+		}
+	}
 
+	EventQueue::EventQueue(size_t capacity, bool usePriorityLanes, Channel channel) :
+		lanes_(),
+		starvation_(),
+		laneCount_(usePriorityLanes ? static_cast<size_t>(Lane::COUNT) : 1),
+		channel_(channel),
+		signal_(0),
+		sleepers_(0),
+		threadID_(std::this_thread::get_id())
+	{
+		for (size_t i = 0; i < laneCount_; i++)
+		{
+			switch (channel_)
+			{
+				case Channel::MPSC:
+					// capacity only bounds the recycled nodes, the list itself never fills up
+					lanes_[i].mpsc = new LockFree::MpscQueue<Event*>(capacity);
+					break;
+				default:
+					lanes_[i].mpmc = new LockFree::Queue<Event*>(capacity);
+					break;
+			}
+		}
 	}
 
 	EventQueue::~EventQueue()
 	{
+		for (size_t i = 0; i < laneCount_; i++)
+		{
+			withLane(i, [](auto& queue) { delete &queue; });
+		}
+	}
 
+	bool EventQueue::push(Event* event)
+	{
+		const size_t lane = laneCount_ == 1 ? 0 : static_cast<size_t>(laneOf(event));
+		return withLane(lane, [event](auto& queue) { return queue.push(event); });
 	}
 
 	bool EventQueue::postEvent(Event* event)
 	{
-		if (queue_.push(event))
+		if (push(event))
 		{
-			cv_.notify_one();
+			notify(false);
 			return true;
 		}
 		return false;
@@ -27,39 +69,194 @@ namespace NativeJS
 
 	bool EventQueue::tryPopEvent(Event*& event)
 	{
-		if (size() > 0)
-			return queue_.pop(event);
-		return false;
+		return pop(std::span<Event*>(&event, 1)) == 1;
 	}
 
 	bool EventQueue::popEvent(Event*& event)
 	{
-		if (queue_.pop(event))
-			return true;
-
-		std::unique_lock lk(mutex_);
-		cv_.wait(lk, [&]() { return size() > 0; });
-		return queue_.pop(event);
-	} 
+		return popBatch(std::span<Event*>(&event, 1)) == 1;
+	}
 	
 	bool EventQueue::popEvent(Event*& event, size_t tickTimeout)
 	{
-		using namespace std::chrono;
+		return popBatch(std::span<Event*>(&event, 1), tickTimeout) == 1;
+	}
 
-		if (queue_.pop(event))
-			return true;
+	bool EventQueue::popEvent(Event*& event, Clock::time_point deadline)
+	{
+		return popBatch(std::span<Event*>(&event, 1), deadline) == 1;
+	}
 
-		std::unique_lock lk(mutex_);
+	size_t EventQueue::pushBatch(std::span<Event* const> events)
+	{
+		size_t count = 0;
 
-		// ! wait_for is not accurate in the milliseconds
-		if (cv_.wait_for(lk, std::chrono::milliseconds(tickTimeout), [&]() { return size() > 0; }))
-			return queue_.pop(event);
+		while (count < events.size())
+		{
+			// runs of events that share a lane are reserved at once
+			const size_t lane = laneCount_ == 1 ? 0 : static_cast<size_t>(laneOf(events[count]));
+			size_t run = 1;
+			while (laneCount_ > 1 && count + run < events.size() && static_cast<size_t>(laneOf(events[count + run])) == lane)
+				run++;
 
-		return false;
+			const size_t pushed = withLane(lane, [run = events.subspan(count, run)](auto& queue) { return queue.pushBatch(run); });
+
+			count += pushed;
+			if (pushed < run)
+				break;
+		}
+
+		if (count > 0)
+			notify(count > 1);
+
+		return count;
+	}
+
+	size_t EventQueue::tryPopBatch(std::span<Event*> events)
+	{
+		return pop(events);
+	}
+
+	size_t EventQueue::popBatch(std::span<Event*> events)
+	{
+		size_t count;
+		while ((count = pop(events)) == 0)
+			waitForEvents(std::nullopt);
+		return count;
+	}
+
+	size_t EventQueue::popBatch(std::span<Event*> events, size_t tickTimeout)
+	{
+		return popBatch(events, Clock::now() + std::chrono::milliseconds(tickTimeout));
+	}
+
+	size_t EventQueue::popBatch(std::span<Event*> events, Clock::time_point deadline)
+	{
+		size_t count;
+		while ((count = pop(events)) == 0)
+		{
+			if (!waitForEvents(deadline))
+				return pop(events);
+		}
+		return count;
 	}
 
 	const size_t EventQueue::size() const
 	{
-		return queue_.size();
+		size_t size = 0;
+		for (size_t i = 0; i < laneCount_; i++)
+			size += laneSize(i);
+		return size;
+	}
+
+	const size_t EventQueue::size(Lane lane) const
+	{
+		const size_t i = static_cast<size_t>(lane);
+		return i < laneCount_ ? laneSize(i) : 0;
+	}
+
+	size_t EventQueue::laneSize(size_t lane) const
+	{
+		return withLane(lane, [](auto& queue) { return queue.size(); });
+	}
+
+	size_t EventQueue::popLane(size_t lane, std::span<Event*> events)
+	{
+		return withLane(lane, [events](auto& queue) { return queue.popBatch(events); });
+	}
+
+	size_t EventQueue::pickLane() const
+	{
+		size_t highest = laneCount_;
+
+		for (size_t i = 0; i < laneCount_; i++)
+		{
+			if (laneSize(i) == 0)
+				continue;
+
+			if (highest == laneCount_)
+				highest = i;
+
+			// a starved lane wins over the higher ones
+			if (starvation_[i] >= MAX_LANE_STARVATION)
+				return i;
+		}
+
+		return highest;
+	}
+
+	size_t EventQueue::pop(std::span<Event*> events)
+	{
+		if (laneCount_ == 1)
+			return popLane(0, events);
+
+		size_t count = 0;
+
+		while (count < events.size())
+		{
+			const size_t lane = pickLane();
+			if (lane == laneCount_)
+				break;
+
+			const size_t popped = popLane(lane, events.subspan(count));
+			if (popped == 0)
+				break;
+
+			count += popped;
+			starvation_[lane] = 0;
+
+			// every lower lane that still holds events was passed over by this pop
+			for (size_t i = lane + 1; i < laneCount_; i++)
+			{
+				if (laneSize(i) > 0)
+					starvation_[i] += popped;
+			}
+		}
+
+		return count;
+	}
+
+	void EventQueue::notify(bool all)
+	{
+		// pairs with the sleeper registration in waitForEvents, either the consumer sees the new signal or we see the sleeper
+		signal_.increment();
+		if (sleepers_.load(std::memory_order::seq_cst) == 0)
+			return;
+
+		if (all)
+			signal_.wakeAll();
+		else
+			signal_.wakeOne();
+	}
+
+	bool EventQueue::waitForEvents(const std::optional<Clock::time_point>& deadline)
+	{
+		// events tend to arrive in bursts, so a short spin usually avoids parking at all
+		for (size_t i = 0; i < EVENT_QUEUE_SPIN_COUNT; i++)
+		{
+			if (size() > 0)
+				return true;
+			Futex::pause();
+		}
+
+		const uint32_t signal = signal_.load();
+		sleepers_.fetch_add(1, std::memory_order::seq_cst);
+
+		bool didTimeout = false;
+
+		if (size() == 0)
+		{
+			if (!deadline.has_value())
+				signal_.wait(signal);
+			else
+				didTimeout = !signal_.waitFor(signal, *deadline - Clock::now());
+		}
+
+		sleepers_.fetch_sub(1, std::memory_order::relaxed);
+
+		if (size() > 0)
+			return true;
+
+		return !didTimeout && (!deadline.has_value() || Clock::now() < *deadline);
 	}
-}
\ No newline at end of file
+}
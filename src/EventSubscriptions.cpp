@@ -0,0 +1,48 @@
+#include "framework.hpp"
+#include "EventSubscriptions.hpp"
+
+namespace NativeJS
+{
+	EventSubscriptions::EventSubscriptions() :
+		mutex_(),
+		subscribers_()
+	{
+
+	}
+
+	EventSubscriptions::~EventSubscriptions()
+	{
+
+	}
+
+	void EventSubscriptions::subscribe(Worker* worker, UINT uMsg)
+	{
+		std::unique_lock lk(mutex_);
+		std::vector<Worker*>& workers = subscribers_[uMsg];
+		if (std::find(workers.begin(), workers.end(), worker) == workers.end())
+			workers.emplace_back(worker);
+	}
+
+	void EventSubscriptions::unsubscribe(Worker* worker, UINT uMsg)
+	{
+		std::unique_lock lk(mutex_);
+		auto it = subscribers_.find(uMsg);
+		if (it != subscribers_.end())
+			std::erase(it->second, worker);
+	}
+
+	void EventSubscriptions::unsubscribeAll(Worker* worker)
+	{
+		std::unique_lock lk(mutex_);
+		for (auto& [uMsg, workers] : subscribers_)
+			std::erase(workers, worker);
+	}
+
+	void EventSubscriptions::collect(UINT uMsg, std::vector<Worker*>& subscribers) const
+	{
+		std::unique_lock lk(mutex_);
+		auto it = subscribers_.find(uMsg);
+		if (it != subscribers_.end())
+			subscribers.insert(subscribers.end(), it->second.begin(), it->second.end());
+	}
+}
@@ -0,0 +1,90 @@
+#include "framework.hpp"
+#include "Futex.hpp"
+
+namespace NativeJS
+{
+	Futex::Futex(uint32_t value) :
+		value_(value)
+	{
+
+	}
+
+	Futex::~Futex()
+	{
+
+	}
+
+#ifdef _WINDOWS
+	void Futex::wait(uint32_t expected)
+	{
+		WaitOnAddress(&value_, &expected, sizeof(expected), INFINITE);
+	}
+
+	bool Futex::waitFor(uint32_t expected, std::chrono::nanoseconds timeout)
+	{
+		using namespace std::chrono;
+
+		const auto deadline = steady_clock::now() + timeout;
+
+		// WaitOnAddress only takes whole milliseconds, the remainder is spun away
+		const DWORD ms = static_cast<DWORD>(duration_cast<milliseconds>(timeout).count());
+		if (ms > 0 && !WaitOnAddress(&value_, &expected, sizeof(expected), ms))
+			return GetLastError() != ERROR_TIMEOUT;
+
+		while (value_.load(std::memory_order::acquire) == expected)
+		{
+			if (steady_clock::now() >= deadline)
+				return false;
+			std::this_thread::yield();
+		}
+
+		return true;
+	}
+
+	void Futex::wakeOne()
+	{
+		WakeByAddressSingle(&value_);
+	}
+
+	void Futex::wakeAll()
+	{
+		WakeByAddressAll(&value_);
+	}
+#elif defined(__linux__)
+	static long futex(std::atomic<uint32_t>& word, int op, uint32_t value, const timespec* timeout)
+	{
+		return syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), op, value, timeout, nullptr, 0);
+	}
+
+	void Futex::wait(uint32_t expected)
+	{
+		futex(value_, FUTEX_WAIT_PRIVATE, expected, nullptr);
+	}
+
+	bool Futex::waitFor(uint32_t expected, std::chrono::nanoseconds timeout)
+	{
+		using namespace std::chrono;
+
+		if (timeout.count() <= 0)
+			return false;
+
+		const seconds secs = duration_cast<seconds>(timeout);
+		const timespec ts = { static_cast<time_t>(secs.count()), static_cast<long>((timeout - secs).count()) };
+
+		if (futex(value_, FUTEX_WAIT_PRIVATE, expected, &ts) == -1)
+			return errno != ETIMEDOUT;
+
+		return true;
+	}
+
+	void Futex::wakeOne()
+	{
+		futex(value_, FUTEX_WAKE_PRIVATE, 1, nullptr);
+	}
+
+	void Futex::wakeAll()
+	{
+		futex(value_, FUTEX_WAKE_PRIVATE, std::numeric_limits<int>::max(), nullptr);
+	}
+#endif
+}
@@ -0,0 +1,50 @@
+#include "framework.hpp"
+#include "HeapLimits.hpp"
+#include "js/BaseEnv.hpp"
+#include "js/JSUtils.hpp"
+#include "App.hpp"
+
+namespace NativeJS
+{
+	bool HeapLimits::load(const JS::BaseEnv& env, v8::Local<v8::Value> val)
+	{
+		if (val.IsEmpty() || !val->IsObject())
+			return false;
+
+		v8::Local<v8::Value> prop;
+
+		if (JS::getFromObject(env, val, "maxOldGenerationMb", prop))
+			JS::parseNumber(env.context(), prop, maxOldGenerationMb);
+		if (JS::getFromObject(env, val, "maxYoungGenerationMb", prop))
+			JS::parseNumber(env.context(), prop, maxYoungGenerationMb);
+		if (JS::getFromObject(env, val, "codeRangeMb", prop))
+			JS::parseNumber(env.context(), prop, codeRangeMb);
+
+		if (JS::getFromObject(env, val, "onNearLimit", prop) && prop->IsString())
+		{
+			const std::string action = JS::parseString(env, prop);
+			if (action == "collect")
+				onNearLimit = Action::Collect;
+			else if (action == "emit")
+				onNearLimit = Action::Emit;
+			else if (action == "terminate")
+				onNearLimit = Action::Terminate;
+			else
+				env.app().logger().warn("Unknown onNearLimit action \"", action, "\"!");
+		}
+
+		return true;
+	}
+
+	void HeapLimits::apply(v8::ResourceConstraints& constraints) const
+	{
+		constexpr size_t MB = 1024 * 1024;
+
+		if (maxOldGenerationMb != 0)
+			constraints.set_max_old_generation_size_in_bytes(maxOldGenerationMb * MB);
+		if (maxYoungGenerationMb != 0)
+			constraints.set_max_young_generation_size_in_bytes(maxYoungGenerationMb * MB);
+		if (codeRangeMb != 0)
+			constraints.set_code_range_size_in_bytes(codeRangeMb * MB);
+	}
+}
@@ -0,0 +1,259 @@
+#include "framework.hpp"
+#include "ModuleResolver.hpp"
+
+namespace NativeJS
+{
+	static bool isBelow(const std::string& path, const std::string& dir)
+	{
+		return path.size() > dir.size() && path.starts_with(dir) && path[dir.size()] == '/';
+	}
+
+	static std::string toKey(const std::filesystem::path& path)
+	{
+		std::string key = path.lexically_normal().generic_string();
+#ifdef _WINDOWS
+		// the file system is case-insensitive, an import resolves whatever case it is spelled in
+		std::transform(key.begin(), key.end(), key.begin(), [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+#endif
+		return key;
+	}
+
+	ModuleResolver::ModuleResolver() :
+		suffixes_(),
+		rootDir_(),
+		mutex_(),
+		entries_(),
+		unscanned_(),
+		resolved_()
+#ifdef __linux__
+		, watchFd_(-1),
+		watches_()
+#endif
+	{ }
+
+	ModuleResolver::~ModuleResolver()
+	{
+#ifdef __linux__
+		if (watchFd_ != -1)
+			close(watchFd_);
+#endif
+	}
+
+	void ModuleResolver::initialize(const std::filesystem::path& rootDir, const std::vector<std::string>& suffixes, bool watch)
+	{
+		std::unique_lock lock(mutex_);
+
+		suffixes_ = suffixes;
+		rootDir_ = toKey(rootDir);
+		while (rootDir_.size() > 1 && rootDir_.back() == '/')
+			rootDir_.pop_back();
+
+#ifdef __linux__
+		if (watch)
+			watchFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+
+		scan(rootDir);
+	}
+
+	bool ModuleResolver::resolve(const std::filesystem::path& fromDir, const std::string& specifier, std::filesystem::path& resolved)
+	{
+		std::string key = fromDir.generic_string();
+		key += '\0';
+		key += specifier;
+
+		{
+			std::shared_lock lock(mutex_);
+			auto it = resolved_.find(key);
+			if (it != resolved_.end())
+			{
+				resolved = it->second;
+				return true;
+			}
+		}
+
+		std::filesystem::path path = specifier;
+		if (path.is_relative())
+			path = fromDir / path;
+
+		if (!exists(path))
+		{
+			bool isValid = false;
+			for (const std::string& suffix : suffixes_)
+			{
+				std::filesystem::path checkPath = path;
+				checkPath += suffix;
+				if (exists(checkPath))
+				{
+					path = std::move(checkPath);
+					isValid = true;
+					break;
+				}
+			}
+
+			if (!isValid)
+				return false;
+		}
+
+		std::unique_lock lock(mutex_);
+		resolved_.insert_or_assign(std::move(key), path);
+		resolved = std::move(path);
+		return true;
+	}
+
+	void ModuleResolver::invalidate()
+	{
+		std::unique_lock lock(mutex_);
+		resolved_.clear();
+	}
+
+	bool ModuleResolver::exists(const std::filesystem::path& path)
+	{
+		const std::string normalized = toKey(path);
+		bool isScanned = false;
+
+		{
+			std::shared_lock lock(mutex_);
+			isScanned = !rootDir_.empty() && isBelow(normalized, rootDir_) && std::none_of(unscanned_.begin(), unscanned_.end(), [&](const std::string& dir) { return isBelow(normalized, dir); });
+			if (isScanned && entries_.contains(normalized))
+				return true;
+		}
+
+		// a watched scan is complete, without a watch the file may have been created since the scan
+		if (isScanned && isWatched())
+			return false;
+
+		if (!std::filesystem::exists(path))
+			return false;
+
+		if (isScanned)
+		{
+			std::unique_lock lock(mutex_);
+			entries_.emplace(normalized);
+		}
+		return true;
+	}
+
+	bool ModuleResolver::isWatched() const
+	{
+#ifdef __linux__
+		return watchFd_ != -1;
+#else
+		return false;
+#endif
+	}
+
+	void ModuleResolver::scan(const std::filesystem::path& dir)
+	{
+		std::error_code error;
+		addDirectory(dir);
+
+		for (auto it = std::filesystem::recursive_directory_iterator(dir, std::filesystem::directory_options::skip_permission_denied, error); !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error))
+		{
+			const std::filesystem::path& path = it->path();
+
+			if (it->is_directory(error))
+			{
+				// e.g. .git or the code cache, which are large and never imported from. symlinked directories, like the
+				// packages of a pnpm node_modules, are not followed to stay clear of cycles and are checked with a stat instead
+				if (path.filename().native().starts_with('.') || it->is_symlink(error))
+				{
+					unscanned_.emplace_back(toKey(path));
+					it.disable_recursion_pending();
+					continue;
+				}
+				addDirectory(path);
+			}
+			else
+			{
+				entries_.emplace(toKey(path));
+			}
+		}
+	}
+
+	void ModuleResolver::addDirectory(const std::filesystem::path& dir)
+	{
+		entries_.emplace(toKey(dir));
+
+#ifdef __linux__
+		if (watchFd_ != -1)
+		{
+			const int wd = inotify_add_watch(watchFd_, dir.c_str(), IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_MODIFY | IN_CLOSE_WRITE | IN_ONLYDIR);
+			if (wd != -1)
+				watches_.insert_or_assign(wd, dir);
+		}
+#endif
+	}
+
+#ifdef __linux__
+	void ModuleResolver::processWatchEvents()
+	{
+		alignas(inotify_event) char buffer[4096];
+		ssize_t length = 0;
+
+		while ((length = read(watchFd_, buffer, sizeof(buffer))) > 0)
+		{
+			std::unique_lock lock(mutex_);
+
+			ssize_t offset = 0;
+			while (offset < length)
+			{
+				const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+				offset += sizeof(inotify_event) + event->len;
+
+				// events were dropped, the scan can no longer be trusted
+				if (event->mask & IN_Q_OVERFLOW)
+				{
+					entries_.clear();
+					unscanned_.clear();
+					scan(rootDir_);
+					resolved_.clear();
+					continue;
+				}
+
+				auto it = watches_.find(event->wd);
+				if (it == watches_.end())
+					continue;
+
+				if (event->mask & IN_IGNORED)
+				{
+					watches_.erase(it);
+					continue;
+				}
+
+				// an edited file keeps its resolutions, only its source is dropped, see App
+				if (event->len == 0 || (event->mask & (IN_MODIFY | IN_CLOSE_WRITE)))
+					continue;
+
+				const std::filesystem::path path = it->second / event->name;
+				const std::string key = toKey(path);
+
+				if (event->mask & (IN_CREATE | IN_MOVED_TO))
+				{
+					// inotify reports a symlink to a directory as a file
+					std::error_code error;
+					if (!(event->mask & IN_ISDIR) && !(std::filesystem::is_symlink(path, error) && std::filesystem::is_directory(path, error)))
+						entries_.emplace(key);
+					else if (!(event->mask & IN_ISDIR) || path.filename().native().starts_with('.'))
+						unscanned_.emplace_back(key);
+					else
+						scan(path);
+				}
+				else if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+				{
+					entries_.erase(key);
+					std::erase(unscanned_, key);
+					if (event->mask & IN_ISDIR)
+					{
+						std::erase_if(entries_, [&](const std::string& entry) { return isBelow(entry, key); });
+						std::erase_if(unscanned_, [&](const std::string& dir) { return isBelow(dir, key); });
+					}
+				}
+
+				// a new file can shadow a suffixed resolution and a removed one can invalidate any of them
+				resolved_.clear();
+			}
+		}
+	}
+#endif
+}
@@ -0,0 +1,272 @@
+#include "framework.hpp"
+#include "ModuleSources.hpp"
+
+namespace NativeJS
+{
+	class ModuleSource::OneByteResource : public v8::String::ExternalOneByteStringResource
+	{
+	public:
+		OneByteResource(std::shared_ptr<const ModuleSource>&& source) : source_(std::move(source)) { }
+
+		const char* data() const override { return source_->oneByte_; }
+		size_t length() const override { return source_->oneByteLength_; }
+
+	private:
+		std::shared_ptr<const ModuleSource> source_;
+	};
+
+	class ModuleSource::TwoByteResource : public v8::String::ExternalStringResource
+	{
+	public:
+		TwoByteResource(std::shared_ptr<const ModuleSource>&& source) : source_(std::move(source)) { }
+
+		const uint16_t* data() const override { return reinterpret_cast<const uint16_t*>(source_->twoByte_.data()); }
+		size_t length() const override { return source_->twoByte_.size(); }
+
+	private:
+		std::shared_ptr<const ModuleSource> source_;
+	};
+
+	static bool isAscii(std::string_view bytes)
+	{
+		unsigned char bits = 0;
+		for (const char c : bytes)
+			bits |= static_cast<unsigned char>(c);
+		return bits < 0x80;
+	}
+
+	/**
+	 * @brief Decodes UTF-8 to UTF-16, invalid sequences become U+FFFD.
+	 */
+	static void decodeUtf8(std::string_view bytes, std::u16string& out)
+	{
+		out.reserve(bytes.size());
+
+		size_t i = 0;
+		while (i < bytes.size())
+		{
+			const unsigned char c = static_cast<unsigned char>(bytes[i]);
+			uint32_t codePoint = 0;
+			size_t length = 0;
+
+			if (c < 0x80)
+			{
+				codePoint = c;
+				length = 1;
+			}
+			else if ((c & 0xE0) == 0xC0)
+			{
+				codePoint = c & 0x1F;
+				length = 2;
+			}
+			else if ((c & 0xF0) == 0xE0)
+			{
+				codePoint = c & 0x0F;
+				length = 3;
+			}
+			else if ((c & 0xF8) == 0xF0)
+			{
+				codePoint = c & 0x07;
+				length = 4;
+			}
+
+			bool isValid = length != 0 && i + length <= bytes.size();
+			for (size_t j = 1; isValid && j < length; j++)
+			{
+				const unsigned char next = static_cast<unsigned char>(bytes[i + j]);
+				isValid = (next & 0xC0) == 0x80;
+				codePoint = (codePoint << 6) | (next & 0x3F);
+			}
+
+			if (!isValid || codePoint > 0x10FFFF)
+			{
+				out.push_back(u'\uFFFD');
+				i++;
+				continue;
+			}
+
+			i += length;
+
+			if (codePoint >= 0x10000)
+			{
+				codePoint -= 0x10000;
+				out.push_back(static_cast<char16_t>(0xD800 + (codePoint >> 10)));
+				out.push_back(static_cast<char16_t>(0xDC00 + (codePoint & 0x3FF)));
+			}
+			else
+			{
+				out.push_back(static_cast<char16_t>(codePoint));
+			}
+		}
+	}
+
+	/*static*/ std::shared_ptr<const ModuleSource> ModuleSource::map(const std::filesystem::path& path, bool isCopied)
+	{
+		std::shared_ptr<ModuleSource> source = std::make_shared<ModuleSource>();
+		size_t size = 0;
+
+#ifdef _WINDOWS
+		HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return nullptr;
+
+		LARGE_INTEGER fileSize = {};
+		if (!GetFileSizeEx(file, &fileSize))
+		{
+			CloseHandle(file);
+			return nullptr;
+		}
+
+		size = static_cast<size_t>(fileSize.QuadPart);
+		if (size > 0)
+		{
+			// the view keeps the file mapped after both handles are closed
+			HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (mapping != nullptr)
+			{
+				source->mapping_ = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+				CloseHandle(mapping);
+			}
+		}
+		CloseHandle(file);
+#else
+		const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd == -1)
+			return nullptr;
+
+		struct stat info = {};
+		if (fstat(fd, &info) == -1)
+		{
+			close(fd);
+			return nullptr;
+		}
+
+		size = static_cast<size_t>(info.st_size);
+		if (size > 0)
+		{
+			void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (mapping != MAP_FAILED)
+				source->mapping_ = mapping;
+		}
+		close(fd);
+#endif
+
+		if (size > 0 && source->mapping_ == nullptr)
+			return nullptr;
+
+		source->mappingSize_ = size;
+
+		std::string_view bytes(static_cast<const char*>(source->mapping_), size);
+		if (bytes.starts_with("\xEF\xBB\xBF"))
+			bytes.remove_prefix(3);
+
+		source->hash_ = Hasher::hash(bytes);
+
+		const bool isOneByte = isAscii(bytes);
+		if (isOneByte && !isCopied)
+		{
+			source->oneByte_ = bytes.data();
+			source->oneByteLength_ = bytes.size();
+		}
+		else
+		{
+			// the copy is shared the same way, so the mapping is not needed anymore
+			if (isOneByte)
+			{
+				source->copy_.assign(bytes);
+				source->oneByte_ = source->copy_.data();
+				source->oneByteLength_ = source->copy_.size();
+			}
+			else
+			{
+				decodeUtf8(bytes, source->twoByte_);
+			}
+#ifdef _WINDOWS
+			UnmapViewOfFile(source->mapping_);
+#else
+			munmap(source->mapping_, source->mappingSize_);
+#endif
+			source->mapping_ = nullptr;
+			source->mappingSize_ = 0;
+		}
+
+		return source;
+	}
+
+	ModuleSource::ModuleSource() :
+		mapping_(nullptr),
+		mappingSize_(0),
+		oneByte_(""),
+		oneByteLength_(0),
+		copy_(),
+		twoByte_(),
+		hash_(0)
+	{ }
+
+	ModuleSource::~ModuleSource()
+	{
+		if (mapping_ == nullptr)
+			return;
+#ifdef _WINDOWS
+		UnmapViewOfFile(mapping_);
+#else
+		munmap(mapping_, mappingSize_);
+#endif
+	}
+
+	v8::MaybeLocal<v8::String> ModuleSource::toString(v8::Isolate* isolate) const
+	{
+		if (isOneByte())
+		{
+			OneByteResource* resource = new OneByteResource(shared_from_this());
+			v8::MaybeLocal<v8::String> str = v8::String::NewExternalOneByte(isolate, resource);
+			// V8 only takes the resource over when it created the string
+			if (str.IsEmpty())
+				delete resource;
+			return str;
+		}
+
+		TwoByteResource* resource = new TwoByteResource(shared_from_this());
+		v8::MaybeLocal<v8::String> str = v8::String::NewExternalTwoByte(isolate, resource);
+		if (str.IsEmpty())
+			delete resource;
+		return str;
+	}
+
+	ModuleSources::ModuleSources() :
+		mutex_(),
+		sources_(),
+		isCopied_(false)
+	{ }
+
+	std::shared_ptr<const ModuleSource> ModuleSources::get(const std::filesystem::path& path)
+	{
+		const std::string key = path.string();
+
+		{
+			std::shared_lock lock(mutex_);
+			auto it = sources_.find(key);
+			if (it != sources_.end())
+				return it->second;
+		}
+
+		std::shared_ptr<const ModuleSource> source = ModuleSource::map(path, isCopied_.load(std::memory_order::relaxed));
+		if (source == nullptr)
+			return nullptr;
+
+		// if another worker stored the file in the meantime its source is used and this mapping is dropped
+		std::unique_lock lock(mutex_);
+		return sources_.try_emplace(key, std::move(source)).first->second;
+	}
+
+	void ModuleSources::setCopied(bool isCopied)
+	{
+		isCopied_.store(isCopied, std::memory_order::relaxed);
+	}
+
+	void ModuleSources::clear()
+	{
+		std::unique_lock lock(mutex_);
+		sources_.clear();
+	}
+}
@@ -0,0 +1,181 @@
+#include "framework.hpp"
+#include "TimerWheel.hpp"
+
+namespace NativeJS
+{
+	TimerWheel::TimerWheel() :
+		start_(Clock::now()),
+		now_(0),
+		size_(0)
+	{
+		for (size_t level = 0; level < LEVELS; level++)
+		{
+			for (size_t slot = 0; slot < SLOTS; slot++)
+			{
+				Timer& head = slots_[level][slot];
+				head.next = &head;
+				head.prev = &head;
+			}
+		}
+	}
+
+	TimerWheel::~TimerWheel()
+	{
+
+	}
+
+	void TimerWheel::schedule(Timer* timer, std::chrono::milliseconds delay, std::chrono::milliseconds interval)
+	{
+		if (timer->isScheduled())
+		{
+			unlink(timer);
+			size_--;
+		}
+
+		const uint64_t current = std::max(tickOf(Clock::now()), now_);
+		const uint64_t ticks = static_cast<uint64_t>(std::max<int64_t>(delay.count(), 0));
+
+		// rounded up to the next tick, so a timer never fires before its delay passed
+		timer->expiry = current + ticks + 1;
+		timer->interval = static_cast<uint64_t>(std::max<int64_t>(interval.count(), 0));
+
+		place(timer);
+		size_++;
+	}
+
+	bool TimerWheel::cancel(Timer* timer)
+	{
+		if (!timer->isScheduled())
+			return false;
+
+		unlink(timer);
+		size_--;
+		return true;
+	}
+
+	void TimerWheel::advance(std::vector<Timer*>& expired)
+	{
+		const uint64_t target = tickOf(Clock::now());
+
+		if (size_ == 0)
+		{
+			now_ = std::max(now_, target);
+			return;
+		}
+
+		const size_t firstExpired = expired.size();
+
+		while (now_ < target)
+		{
+			now_++;
+
+			// cascade from the highest level that wrapped around, so timers can trickle down through every level
+			size_t top = 0;
+			while (top + 1 < LEVELS && (now_ & ((uint64_t(1) << (LEVEL_BITS * (top + 1))) - 1)) == 0)
+				top++;
+
+			for (size_t level = top; level > 0; level--)
+				cascade(level);
+
+			Timer& head = slots_[0][now_ & SLOT_MASK];
+			while (head.next != &head)
+			{
+				Timer* timer = head.next;
+				unlink(timer);
+				size_--;
+				expired.emplace_back(timer);
+			}
+
+			if (size_ == 0)
+			{
+				now_ = target;
+				break;
+			}
+		}
+
+		for (size_t i = firstExpired; i < expired.size(); i++)
+		{
+			Timer* timer = expired[i];
+			if (timer->interval == 0)
+				continue;
+
+			// missed periods are skipped, so an interval is only reported once per advance
+			if (timer->expiry <= now_)
+				timer->expiry += timer->interval * ((now_ - timer->expiry) / timer->interval + 1);
+
+			place(timer);
+			size_++;
+		}
+	}
+
+	std::optional<TimerWheel::Clock::time_point> TimerWheel::nextExpiry() const
+	{
+		if (size_ == 0)
+			return std::nullopt;
+
+		// level 0 is exact up to the next cascade, past that the wheel has to be advanced to know more
+		const uint64_t cascadeTick = ((now_ >> LEVEL_BITS) + 1) << LEVEL_BITS;
+
+		for (uint64_t tick = now_ + 1; tick < cascadeTick; tick++)
+		{
+			const Timer& head = slots_[0][tick & SLOT_MASK];
+			if (head.next != &head)
+				return start_ + std::chrono::milliseconds(tick);
+		}
+
+		return start_ + std::chrono::milliseconds(cascadeTick);
+	}
+
+	uint64_t TimerWheel::tickOf(Clock::time_point time) const
+	{
+		if (time <= start_)
+			return 0;
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(time - start_).count());
+	}
+
+	void TimerWheel::place(Timer* timer)
+	{
+		const uint64_t expiry = std::max(timer->expiry, now_);
+		const uint64_t delta = expiry - now_;
+
+		size_t level = 0;
+		while (level + 1 < LEVELS && delta >= (uint64_t(1) << (LEVEL_BITS * (level + 1))))
+			level++;
+
+		uint64_t slotTick = expiry;
+
+		// timers past the range of the wheel are parked in the farthest slot and re-placed when it cascades
+		if (delta >= (uint64_t(1) << (LEVEL_BITS * LEVELS)))
+			slotTick = now_ + (uint64_t(1) << (LEVEL_BITS * LEVELS)) - 1;
+
+		Timer& head = slots_[level][(slotTick >> (LEVEL_BITS * level)) & SLOT_MASK];
+		timer->next = &head;
+		timer->prev = head.prev;
+		head.prev->next = timer;
+		head.prev = timer;
+	}
+
+	void TimerWheel::cascade(const size_t level)
+	{
+		Timer& head = slots_[level][(now_ >> (LEVEL_BITS * level)) & SLOT_MASK];
+
+		Timer* timer = head.next;
+		head.next = &head;
+		head.prev = &head;
+
+		while (timer != &head)
+		{
+			Timer* next = timer->next;
+			place(timer);
+			timer = next;
+		}
+	}
+
+	void TimerWheel::unlink(Timer* timer)
+	{
+		timer->prev->next = timer->next;
+		timer->next->prev = timer->prev;
+		timer->next = nullptr;
+		timer->prev = nullptr;
+	}
+}
@@ -3,7 +3,7 @@
 #include "WindowManager.hpp"
 #include "App.hpp"
 #include "utils.hpp"
-#include "JS/Env.hpp"
+#include "js/Env.hpp"
 
 namespace NativeJS
 {
@@ -41,6 +41,13 @@ namespace NativeJS
 			jsObjects_.emplace(worker, worker->env());
 			jsObjects_.at(worker).wrap(jsWindow);
 		});
+
+		// only the messages a JS window reacts to are routed to its worker
+		subscriptions_.subscribe(worker, WM_CLOSE);
+		subscriptions_.subscribe(worker, WM_DESTROY);
+		subscriptions_.subscribe(worker, WM_MOUSEMOVE);
+		subscriptions_.subscribe(worker, WM_SIZE);
+		subscriptions_.subscribe(worker, WM_MOUSEWHEEL);
 	}
 
 	JS::Window* Window::getJsObject(Worker* worker)
@@ -52,6 +52,12 @@ namespace NativeJS
 		}
 	}
 
+	void WindowManager::unsubscribeAll(Worker* worker)
+	{
+		for (auto& [handle, window] : windowsMap_)
+			window->subscriptions().unsubscribeAll(worker);
+	}
+
 	Window* WindowManager::getWindow(Window::Handle handle)
 	{
 		if(windowsMap_.contains(handle))
@@ -5,51 +5,126 @@
 #include "constants.hpp"
 #include "EventQueue.hpp"
 #include "App.hpp"
+#include "js/JSUtils.hpp"
 
 namespace NativeJS
 {
-	Worker::Worker(App& app, std::filesystem::path&& envEntry, Worker* parent) :
+	static inline int16_t lowWord(uintptr_t value) { return static_cast<int16_t>(value & 0xFFFF); }
+	static inline int16_t highWord(uintptr_t value) { return static_cast<int16_t>((value >> 16) & 0xFFFF); }
+
+	/**
+	 * @returns the coalesced positions of a mouse event as [x, y] pairs, oldest first
+	 */
+	static v8::Local<v8::Array> createSamples(const JS::Env& env, const NativeEvent& e)
+	{
+		const std::vector<OSEvent>& samples = e.samples();
+		v8::Local<v8::Array> arr = v8::Array::New(env.isolate(), static_cast<int>(samples.size()));
+		for (size_t i = 0; i < samples.size(); i++)
+		{
+			v8::Local<v8::Array> sample = v8::Array::New(env.isolate(), 2);
+			sample->Set(env.context(), 0, JS::number(env, lowWord(samples[i].lParam)));
+			sample->Set(env.context(), 1, JS::number(env, highWord(samples[i].lParam)));
+			arr->Set(env.context(), static_cast<uint32_t>(i), sample);
+		}
+		return arr;
+	}
+
+	Worker::Worker(App& app, std::filesystem::path&& envEntry, Worker* parent, const HeapLimits& heapLimits) :
 		app_(app),
 		entry_(envEntry),
 		parentWorker_(parent),
+		heapLimits_(heapLimits),
 		index_(0),
 		mutex_(),
 		cv_(),
-		thread_([&]() { returnCode_ = entry(); }),
+		thread_(),
 		returnCode_(0),
-		eventQueue_(nullptr),
 		isRunning_(false),
-		isTerminated_(false),
 		isBlocked_(false),
+		isTerminated_(false),
+		isStandby_(false),
+		isStopping_(false),
 		blockingWorkMutex_(),
-		blockingWorkCv_()
+		blockingWorkCv_(),
+		eventQueue_(nullptr)
 	{
 		assert(entry_.is_absolute());
-		std::unique_lock lk(mutex_);
-		cv_.wait(lk, [&]() { return isRunning_.load(std::memory_order::acquire); });
+		start();
 	}
 
-	Worker::Worker(App& app, const std::filesystem::path& envEntry, Worker* parent) :
+	Worker::Worker(App& app, const std::filesystem::path& envEntry, Worker* parent, const HeapLimits& heapLimits) :
 		app_(app),
 		entry_(envEntry),
 		parentWorker_(parent),
+		heapLimits_(heapLimits),
 		index_(0),
 		mutex_(),
 		cv_(),
-		thread_([&]() { returnCode_ = entry(); }),
+		thread_(),
 		returnCode_(0),
-		eventQueue_(nullptr),
 		isRunning_(false),
-		isTerminated_(false),
 		isBlocked_(false),
+		isTerminated_(false),
+		isStandby_(false),
+		isStopping_(false),
 		blockingWorkMutex_(),
-		blockingWorkCv_()
+		blockingWorkCv_(),
+		eventQueue_(nullptr)
 	{
 		assert(entry_.is_absolute());
+		start();
+	}
+
+	Worker::Worker(App& app, const HeapLimits& heapLimits) :
+		app_(app),
+		entry_(),
+		parentWorker_(nullptr),
+		heapLimits_(heapLimits),
+		index_(0),
+		mutex_(),
+		cv_(),
+		thread_(),
+		returnCode_(0),
+		isRunning_(false),
+		isBlocked_(false),
+		isTerminated_(false),
+		isStandby_(true),
+		isStopping_(false),
+		blockingWorkMutex_(),
+		blockingWorkCv_(),
+		eventQueue_(nullptr)
+	{
+		start();
+	}
+
+	void Worker::start()
+	{
+		// started once every member is initialized, the thread reads them right away
+		thread_ = std::thread([&]() { returnCode_ = entry(); });
 		std::unique_lock lk(mutex_);
 		cv_.wait(lk, [&]() { return isRunning_.load(std::memory_order::acquire); });
 	}
 
+	void Worker::bind(std::filesystem::path&& entry, Worker* parent)
+	{
+		assert(entry.is_absolute());
+		{
+			std::lock_guard lk(mutex_);
+			assert(isStandby_);
+			entry_ = std::move(entry);
+			parentWorker_ = parent;
+			isStandby_ = false;
+		}
+		cv_.notify_all();
+	}
+
+	bool Worker::waitForEntry()
+	{
+		std::unique_lock lk(mutex_);
+		cv_.wait(lk, [&]() { return !isStandby_ || isStopping_; });
+		return !isStandby_;
+	}
+
 	Worker::~Worker()
 	{
 		int returnCode = 0;
@@ -64,6 +139,12 @@ namespace NativeJS
 
 		if (thread_.joinable())
 		{
+			{
+				std::lock_guard lk(mutex_);
+				isStopping_ = true;
+			}
+			// a standby worker waits for its entry instead of reading its queue
+			cv_.notify_all();
 			eventQueue_->postEvent(Event::getTerminateEvent());
 			thread_.join();
 			exitCode = returnCode_;
@@ -75,111 +156,150 @@ namespace NativeJS
 
 	int Worker::entry()
 	{
-		eventQueue_ = new EventQueue(MAX_QUEUE_SIZE);
+		eventQueue_ = new EventQueue(MAX_QUEUE_SIZE, true, EventQueue::Channel::MPSC);
+		events_.bindToCurrentThread();
 
 		isRunning_.store(true, std::memory_order::release);
 		cv_.notify_all();
 		printf("%zu\n", this);
-		JS::Env env = JS::Env(app_, this, entry_, parentWorker_);
+		bool isStandby = false;
+		{
+			std::lock_guard lk(mutex_);
+			isStandby = isStandby_;
+		}
+
+		JS::Env env = JS::Env(app_, this, isStandby ? std::filesystem::path() : entry_, isStandby ? nullptr : parentWorker_);
 
 		env_ = &env;
 
 		JS::Env::Scope scope(env);
 
+		// a standby worker builds its isolate and context ahead of time and only waits for App::createWorker to hand it an entry
+		if (isStandby)
+		{
+			if (!waitForEntry())
+				return 0;
+			env.bind(entry_, parentWorker_);
+		}
+
 		env.loadEntryModule();
 
-		Event* event;
+		Event* events[MAX_EVENT_BATCH];
+		size_t count = 0;
+		size_t i = 0;
 
 		bool terminated = false;
+		int exitCode = 0;
 
 		const size_t tickTimeout = app_.getTickTimeout();
 
 		while (!terminated)
 		{
+			// a whole batch is processed under a single scope
 			JS::Env::Scope scope(env);
-			if (eventQueue_->popEvent(event))
+			count = popEvents(events, tickTimeout);
+			if (count > 0)
 			{
-				switch (event->type())
+				for (i = 0; i < count; i++)
 				{
-					case Event::Type::Terminate:
-					{
-						terminated = true;
-						break;
-					}
-					case Event::Type::Native:
+					Event* event = events[i];
+					switch (event->type())
 					{
-						NativeEvent& e = event->as<NativeEvent>();
-
-						const bool wasLastProcessed = e.process([&](const OSEvent& nativeEvent)
+						case Event::Type::Terminate:
+						{
+							terminated = true;
+							break;
+						}
+						case Event::Type::Native:
 						{
-							auto getWindow = [&]() { return env.app().windowManager().getWindow(nativeEvent.hwnd)->getJsObject(env.worker()); };
+							NativeEvent& e = event->as<NativeEvent>();
 
-							switch (nativeEvent.uMsg)
+							const bool wasLastProcessed = e.process([&](const OSEvent& nativeEvent)
 							{
-								case WM_DESTROY:
-								{
-									NativeJS::JS::Window* win = getWindow();
+								auto getWindow = [&]() { return env.app().windowManager().getWindow(nativeEvent.hwnd)->getJsObject(env.worker()); };
 
-									if (win != nullptr)
-										win->onClosed();
-								}
-								break;
-								case WM_CLOSE:
+								switch (nativeEvent.uMsg)
 								{
-									NativeJS::JS::Window* win = getWindow();
-									if (win != nullptr)
-										win->onClose({ env.createEvent(event) });
-								}
-								break;
-								case WM_QUIT:
-								{
-									if (env_->isJsAppInitialized())
-										env.jsApp().onQuit({ env.createEvent(event) });
+									case WM_DESTROY:
+									{
+										NativeJS::JS::Window* win = getWindow();
+
+										if (win != nullptr)
+											win->onClosed();
+									}
+									break;
+									case WM_CLOSE:
+									{
+										NativeJS::JS::Window* win = getWindow();
+										if (win != nullptr)
+											win->onClose({ env.createEvent(event) });
+									}
+									break;
+									case WM_QUIT:
+									{
+										if (env_->isJsAppInitialized())
+											env.jsApp().onQuit({ env.createEvent(event) });
+									}
+									break;
+									case WM_MOUSEMOVE:
+									{
+										NativeJS::JS::Window* win = getWindow();
+										if (win != nullptr)
+											win->onMouseMove({ JS::number(env, lowWord(nativeEvent.lParam)), JS::number(env, highWord(nativeEvent.lParam)), createSamples(env, e) });
+									}
+									break;
+									case WM_SIZE:
+									{
+										NativeJS::JS::Window* win = getWindow();
+										if (win != nullptr)
+											win->onResize({ JS::number(env, static_cast<uint16_t>(lowWord(nativeEvent.lParam))), JS::number(env, static_cast<uint16_t>(highWord(nativeEvent.lParam))) });
+									}
+									break;
+									case WM_MOUSEWHEEL:
+									{
+										NativeJS::JS::Window* win = getWindow();
+										if (win != nullptr)
+											win->onScroll({ JS::number(env, highWord(nativeEvent.wParam)), createSamples(env, e) });
+									}
+									break;
 								}
-								break;
-							}
-						});
+							});
 
-						if (wasLastProcessed)
-						{
-							app_.postEvent(std::addressof(e), true);
+							if (wasLastProcessed)
+							{
+								app_.postEvent(std::addressof(e), true);
+							}
 						}
-					}
-					break;
-					case Event::Type::Async:
-					{
-						AsyncEvent& e = event->as<AsyncEvent>();
-						e.resolve();
-						events_.remove(event);
-					}
-					break;
-					case Event::Type::Message:
-					{
-						MessageEvent& e = event->as<MessageEvent>();
-						if (std::addressof(e.sender()) != this)
+						break;
+						case Event::Type::Async:
 						{
-							env.emitMessage(e);
-							e.sender().postEvent(event);
+							AsyncEvent& e = event->as<AsyncEvent>();
+							e.resolve();
+							events_.remove(event);
 						}
-						else
+						break;
+						case Event::Type::Message:
 						{
-							e.resolvePromise();
-							events_.remove(event);
+							MessageEvent& e = event->as<MessageEvent>();
+							if (std::addressof(e.sender()) != this)
+							{
+								env.emitMessage(e);
+								e.sender().postEvent(event);
+							}
+							else
+							{
+								e.resolvePromise();
+								events_.remove(event);
+							}
 						}
+						break;
 					}
-					break;
-					case Event::Type::Timeout:
-					{
-						TimeoutEvent& e = event->as<TimeoutEvent>();
-						env.resolveTimeout(e.timeoutIndex);
-					}
-					break;
-				}
 
-				if (terminated)
-					break;
+					if (terminated)
+						break;
+				}
 			}
-			else
+			else if (tickTimeout != 0)
 			{
 				if (env_->isJsAppInitialized())
 					env_->jsApp().onTick();
@@ -187,10 +307,44 @@ namespace NativeJS
 
 			if (terminated)
 				break;
+
+			if (!env.handleNearHeapLimit())
+			{
+				app_.logger().error("Worker ", index_, " reached its heap limit!");
+				exitCode = HEAP_LIMIT_EXIT_CODE;
+				break;
+			}
+
+			resolveTimers();
 		}
 
 		isRunning_.store(false, std::memory_order::release);
 
+		// the work of the imports must be off the async pool before their events are released below
+		env.cancelImports();
+
+		auto releaseEvent = [&](Event* event)
+		{
+			switch (event->type())
+			{
+				case Event::Type::Async:
+				{
+					events_.remove(event);
+				}
+				break;
+				case Event::Type::Message:
+				{
+					if (std::addressof(event->as<MessageEvent>().sender()) == this)
+						events_.remove(event);
+				}
+				break;
+			}
+		};
+
+		// events popped in the same batch as the terminate event were never processed
+		for (i = i + 1; i < count; i++)
+			releaseEvent(events[i]);
+
 		events_.forEach([&](Event* event)
 		{
 			if (event->cancel())
@@ -200,26 +354,49 @@ namespace NativeJS
 		while (events_.size() > 0)
 		{
 			JS::Env::Scope scope(env);
-			if (eventQueue_->popEvent(event))
-			{
-				switch (event->type())
-				{
-					case Event::Type::Async:
-					{
-						events_.remove(event);
-					}
-					break;
-					case Event::Type::Message:
-					{
-						if (std::addressof(event->as<MessageEvent>().sender()) == this)
-							events_.remove(event);
-					}
-					break;
-				}
-			}
+			count = eventQueue_->popBatch(events);
+			for (i = 0; i < count; i++)
+				releaseEvent(events[i]);
 		}
 
-		return 0;
+		return exitCode;
+	}
+
+	size_t Worker::popEvents(std::span<Event*> events, const size_t tickTimeout)
+	{
+		using namespace std::chrono;
+
+		std::optional<TimerWheel::Clock::time_point> expiry = timers_.nextExpiry();
+
+		if (!expiry.has_value() && tickTimeout == 0)
+			return eventQueue_->popBatch(events);
+
+		// the next timer deadline bounds how long the queue may block
+		EventQueue::Clock::time_point deadline = EventQueue::Clock::time_point::max();
+		if (tickTimeout != 0)
+			deadline = EventQueue::Clock::now() + milliseconds(tickTimeout);
+		if (expiry.has_value())
+			deadline = std::min(deadline, *expiry);
+
+		if (deadline <= EventQueue::Clock::now())
+			return eventQueue_->tryPopBatch(events);
+
+		return eventQueue_->popBatch(events, deadline);
+	}
+
+	void Worker::resolveTimers()
+	{
+		timers_.advance(expiredTimers_);
+
+		// a callback earlier in the batch may clear a later timeout and free it, so they are only reached through their ids
+		for (TimerWheel::Timer* timer : expiredTimers_)
+			expiredTimeouts_.push_back(timer->as<JS::Timeout>()->id());
+		expiredTimers_.clear();
+
+		for (const size_t id : expiredTimeouts_)
+			env_->resolveTimeout(id);
+
+		expiredTimeouts_.clear();
 	}
 
 	bool Worker::postEvent(Event* event)
@@ -257,4 +434,28 @@ namespace NativeJS
 		events_.remove(e);
 		return false;
 	}
+
+	BlockingEvent* Worker::postBlockingWork(WorkCallback work, void* data)
+	{
+		BlockingEvent* e = events_.create<BlockingEvent>(*this, work, data);
+		if (!app_.postEvent(e, false))
+		{
+			events_.remove(e);
+			return nullptr;
+		}
+		return e;
+	}
+
+	void Worker::waitForBlockingWork(std::span<BlockingEvent* const> events)
+	{
+		isBlocked_.store(true, std::memory_order::release);
+		std::unique_lock lk(blockingWorkMutex_);
+		blockingWorkCv_.wait(lk, [&]() { return std::any_of(events.begin(), events.end(), [](const BlockingEvent* e) { return e->isDone(); }); });
+		isBlocked_.store(false, std::memory_order::release);
+	}
+
+	void Worker::removeEvent(Event* event)
+	{
+		events_.remove(event);
+	}
 }
\ No newline at end of file
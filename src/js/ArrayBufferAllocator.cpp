@@ -0,0 +1,59 @@
+#include "framework.hpp"
+#include "js/ArrayBufferAllocator.hpp"
+#include "ArrayBufferPool.hpp"
+
+namespace NativeJS::JS
+{
+	ArrayBufferAllocator::ArrayBufferAllocator(ArrayBufferPool& pool) :
+		pool_(pool),
+		liveBytes_(0),
+		peakBytes_(0),
+		totalBytes_(0),
+		allocations_(0)
+	{ }
+
+	void* ArrayBufferAllocator::Allocate(size_t length)
+	{
+		return alloc(length, true);
+	}
+
+	void* ArrayBufferAllocator::AllocateUninitialized(size_t length)
+	{
+		return alloc(length, false);
+	}
+
+	void ArrayBufferAllocator::Free(void* data, size_t length)
+	{
+		if (data == nullptr)
+			return;
+		pool_.free(data, length);
+		liveBytes_.fetch_sub(length, std::memory_order::relaxed);
+	}
+
+	ArrayBufferAllocator::Stats ArrayBufferAllocator::stats() const
+	{
+		return Stats {
+			.liveBytes = liveBytes_.load(std::memory_order::relaxed),
+			.peakBytes = peakBytes_.load(std::memory_order::relaxed),
+			.totalBytes = totalBytes_.load(std::memory_order::relaxed),
+			.allocations = allocations_.load(std::memory_order::relaxed)
+		};
+	}
+
+	void* ArrayBufferAllocator::alloc(size_t length, bool zeroed)
+	{
+		void* data = pool_.alloc(length, zeroed);
+		if (data == nullptr)
+			return nullptr;
+
+		const size_t live = liveBytes_.fetch_add(length, std::memory_order::relaxed) + length;
+		totalBytes_.fetch_add(length, std::memory_order::relaxed);
+		allocations_.fetch_add(1, std::memory_order::relaxed);
+
+		size_t peak = peakBytes_.load(std::memory_order::relaxed);
+		while (live > peak && !peakBytes_.compare_exchange_weak(peak, live, std::memory_order::relaxed))
+			;
+
+		return data;
+	}
+}
@@ -6,15 +6,27 @@
 #include "js/JSConsole.hpp"
 #include "js/NativeJSModule.hpp"
 #include "js/JSProcess.hpp"
+#include "js/ArrayBufferAllocator.hpp"
+#include "js/Snapshot.hpp"
 
 namespace NativeJS::JS
 {
-	BaseEnv::BaseEnv(NativeJS::App& app) :
-		app_(app)
+	BaseEnv::BaseEnv(NativeJS::App& app, const HeapLimits& heapLimits) :
+		app_(app),
+		arrayBufferAllocator_(new ArrayBufferAllocator(app.arrayBufferPool())),
+		snapshotCreator_(nullptr),
+		isFromSnapshot_(app.snapshot().isLoaded())
 	{
 		Logger& logger = app_.logger();
 		logger.debug("Creating V8 Buffer Allocator...");
-		createParams_.array_buffer_allocator = v8::ArrayBuffer::Allocator::NewDefaultAllocator();
+		createParams_.array_buffer_allocator = arrayBufferAllocator_;
+		heapLimits.apply(createParams_.constraints);
+
+		if (isFromSnapshot_)
+		{
+			createParams_.snapshot_blob = app.snapshot().startupData();
+			createParams_.external_references = Snapshot::externalReferences();
+		}
 
 		logger.debug("Creating V8 Isolate...");
 		isolate_ = v8::Isolate::New(createParams_);
@@ -25,21 +37,40 @@ namespace NativeJS::JS
 		v8::Local<v8::Context> ctx = v8::Context::New(isolate_);
 		v8::Context::Scope contextScope(ctx);
 
-		context_.Set(isolate_, ctx);
+		context_.Reset(isolate_, ctx);
 		
 		assert(isolate_->GetNumberOfDataSlots() != 0);
 		isolate_->SetData(0, this);
 	}
 
+	BaseEnv::BaseEnv(NativeJS::App& app, v8::SnapshotCreator& creator) :
+		app_(app),
+		arrayBufferAllocator_(nullptr),
+		isolate_(creator.GetIsolate()),
+		snapshotCreator_(std::addressof(creator)),
+		isFromSnapshot_(false)
+	{
+		v8::HandleScope handleScope(isolate_);
+
+		context_.Reset(isolate_, v8::Context::New(isolate_));
+
+		assert(isolate_->GetNumberOfDataSlots() != 0);
+		isolate_->SetData(0, this);
+	}
+
 	BaseEnv::~BaseEnv()
 	{
 		Logger& logger = app_.logger();
 		logger.debug("Disposing Env...");
+		context_.Reset();
+
+		if (snapshotCreator_ != nullptr)
+			return;
 
 		logger.debug("Disposing V8::Isolate...");
 		isolate_->Dispose();
 		logger.debug("Disposing v8::ArrayBufferAllocator...");
-		delete createParams_.array_buffer_allocator;
+		delete arrayBufferAllocator_;
 	}
 
 	void BaseEnv::throwException(const char* error) const
@@ -5,6 +5,9 @@
 #include "js/JSObject.hpp"
 #include "js/NativeJSModule.hpp"
 #include "js/JSGlobals.hpp"
+#include "js/JSProcess.hpp"
+#include "js/ModuleGraph.hpp"
+#include "constants.hpp"
 
 namespace NativeJS::JS
 {
@@ -17,32 +20,61 @@ namespace NativeJS::JS
 	Env::Scope::~Scope() { }
 
 	Env::Env(NativeJS::App& app, NativeJS::Worker* worker, const std::filesystem::path& entry, NativeJS::Worker* parentWorker) :
-		BaseEnv(app),
-		worker_(worker),
+		BaseEnv(app, worker->heapLimits()),
 		parentWorker_(parentWorker),
-		isJsAppInitialized_(false),
+		worker_(worker),
 		entry_(entry),
 		nativeJSModule_(),
+		jsClasses_(*this),
 		jsApp_(*this),
 		jsSelfWorker_(*this),
-		jsClasses_(*this)
+		isJsAppInitialized_(false),
+		isNearHeapLimit_(false),
+		mustTerminate_(false)
 	{
 		initialize(worker);
 	}
 
 	Env::Env(NativeJS::App& app, NativeJS::Worker* worker, std::filesystem::path&& entry, NativeJS::Worker* parentWorker) :
-		BaseEnv(app),
-		worker_(worker),
+		BaseEnv(app, worker->heapLimits()),
 		parentWorker_(parentWorker),
-		isJsAppInitialized_(false),
-		entry_(entry),
+		worker_(worker),
+		entry_(std::move(entry)),
+		jsClasses_(*this),
 		jsApp_(*this),
 		jsSelfWorker_(*this),
-		jsClasses_(*this)
+		isJsAppInitialized_(false),
+		isNearHeapLimit_(false),
+		mustTerminate_(false)
 	{
 		initialize(worker);
 	}
 
+	Env::Env(NativeJS::App& app, v8::SnapshotCreator& creator) :
+		BaseEnv(app, creator),
+		parentWorker_(nullptr),
+		worker_(nullptr),
+		entry_(),
+		jsClasses_(*this),
+		jsApp_(*this),
+		jsSelfWorker_(*this),
+		isJsAppInitialized_(false),
+		isNearHeapLimit_(false),
+		mustTerminate_(false)
+	{
+		Scope scope(*this);
+
+		isolate()->SetData(0, this);
+
+		jsClasses_.initialize();
+
+		JS::Object global(*this, context()->Global());
+		JS::JSGlobals::expose(*this, global);
+
+		jsClasses_.serialize(creator, context());
+		creator.SetDefaultContext(context());
+	}
+
 	void Env::initialize(NativeJS::Worker* worker)
 	{
 		Scope scope(*this);
@@ -54,33 +86,71 @@ namespace NativeJS::JS
 
 		internalSymbol_.Set(isolate(), v8::Symbol::New(isolate(), string(*this, "INTERNAL")));
 
-		// initialize all the js objects/classes/functions
-		jsClasses_.initialize();
+		isolate()->SetHostInitializeImportMetaObjectCallback(initializeImportMeta);
+		isolate()->SetHostImportModuleDynamicallyCallback(importModuleDynamically);
+
+		isolate()->AddNearHeapLimitCallback(nearHeapLimit, this);
+		// puts the limit back once the heap shrank, so the next spike is handled the same way
+		isolate()->AutomaticallyRestoreInitialHeapLimit();
 
-		// expose globals
 		JS::Object global(*this, context()->Global());
-		JS::JSGlobals::expose(*this, global);
+
+		if (isFromSnapshot())
+		{
+			// the classes and globals were deserialized with the context
+			jsClasses_.deserialize(context());
+		}
+		else
+		{
+			// initialize all the js objects/classes/functions
+			jsClasses_.initialize();
+
+			// expose globals
+			JS::JSGlobals::expose(*this, global);
+		}
+
+		// the process args differ on every run, so they are never part of the snapshot
+		JS::Process::expose(*this, global);
 
 		// create the native-js module
 		nativeJSModule_.Set(isolate(), JS::NativeJSModule::create(*this));
 
 		jsSelfWorker_.wrap(jsClasses_.workerClass.instantiate({ v8::External::New(isolate(), worker_) }).ToLocalChecked());
 		if (parentWorker_ != nullptr)
+			addParentJsWorker();
+	}
+
+	void Env::bind(const std::filesystem::path& entry, NativeJS::Worker* parentWorker)
+	{
+		assert(entry_.empty() && parentWorker_ == nullptr);
+		entry_ = entry;
+		parentWorker_ = parentWorker;
+		if (parentWorker_ != nullptr)
+			addParentJsWorker();
+	}
+
+	void Env::addParentJsWorker()
+	{
+		jsWorkers_.emplace(parentWorker_, *this);
+		JS::Worker& w = jsWorkers_.at(parentWorker_);
+		w.wrap(jsClasses_.workerClass.instantiate({ v8::External::New(isolate(), parentWorker_) }).ToLocalChecked());
+		w.setWeak([](const v8::WeakCallbackInfo<ObjectWrapper>& data)
 		{
-			jsWorkers_.emplace(parentWorker_, *this);
-			JS::Worker& w = jsWorkers_.at(parentWorker_);
-			w.wrap(jsClasses_.workerClass.instantiate({ v8::External::New(isolate(), parentWorker_) }).ToLocalChecked());
-			w.setWeak([](const v8::WeakCallbackInfo<ObjectWrapper>& data)
-			{
-				const Env& env = data.GetParameter()->env();
-				NativeJS::Worker* worker = static_cast<NativeJS::Worker*>(data.GetParameter()->value().As<v8::Object>()->GetInternalField(0).As<v8::External>()->Value());
-				env.removeJsWorker(worker);
-			});
-		}
+			const Env& env = data.GetParameter()->env();
+			NativeJS::Worker* worker = static_cast<NativeJS::Worker*>(data.GetParameter()->value().As<v8::Object>()->GetInternalField(0).As<v8::External>()->Value());
+			env.removeJsWorker(worker);
+		});
 	}
 
 	Env::~Env()
 	{
+		// the graphs hold handles and StreamedSources, which have to go before the isolate
+		cancelImports();
+
+		// a snapshot env never registered the callback
+		if (worker_ != nullptr)
+			isolate()->RemoveNearHeapLimitCallback(nearHeapLimit, 0);
+
 		for (auto& [first, second] : jsWorkers_)
 		{
 			if (first->parentWorker_ == worker_)
@@ -98,10 +168,30 @@ namespace NativeJS::JS
 		}
 	}
 
-	/*static*/ v8::MaybeLocal<v8::Module> Env::importModule(v8::Local<v8::Context> context, v8::Local<v8::String> specifier, v8::Local<v8::FixedArray> import_assertions, v8::Local<v8::Module> referrer)
+	void Env::cancelImports() const
 	{
-		const int id = referrer->ScriptId();
+		imports_.clear();
+	}
 
+	/*static*/ void Env::initializeImportMeta(v8::Local<v8::Context> context, v8::Local<v8::Module> module, v8::Local<v8::Object> meta)
+	{
+		const Env& env = Env::fromContext(context);
+
+		auto it = env.modulesPaths_.find(module->ScriptId());
+		if (it == env.modulesPaths_.end())
+			return;
+
+		const std::filesystem::path path(it->second);
+		std::string dirname = (path / "..").lexically_normal().string();
+		std::replace(dirname.begin(), dirname.end(), '\\', '/');
+
+		JS::Object obj(env, meta);
+		obj.set("dirname", JS::string(env, dirname));
+		obj.set("filename", JS::string(env, path.filename().string()));
+	}
+
+	/*static*/ v8::MaybeLocal<v8::Module> Env::importModule(v8::Local<v8::Context> context, v8::Local<v8::String> specifier, v8::Local<v8::FixedArray> import_assertions, v8::Local<v8::Module> referrer)
+	{
 		Env& env = *static_cast<Env*>(context->GetIsolate()->GetData(0));
 
 		std::string import = JS::parseString(env, specifier);
@@ -111,61 +201,169 @@ namespace NativeJS::JS
 		if (import.compare("native-js") == 0)
 			return v8::MaybeLocal<v8::Module>(env.nativeJSModule_.Get(env.isolate()));
 
-		std::filesystem::path importPath = import;
-		std::filesystem::path fromPath;
+		auto it = env.modulesPaths_.find(referrer->ScriptId());
+		const std::string referrerPath = it != env.modulesPaths_.end() ? it->second : std::string();
 
-		if (!importPath.is_relative())
+		std::filesystem::path importPath;
+
+		if (!env.resolveImport(referrerPath, import, importPath))
 		{
-			fromPath = std::filesystem::path("");
+			env.app().logger().warn("Could not resolve import path for ", import, "!");
+			return v8::MaybeLocal<v8::Module>();
+		}
+
+		// the modules of the graph were already compiled by ModuleGraph
+		v8::Local<v8::Module> module;
+		if (env.findModule(importPath.string()).ToLocal(&module))
+			return module;
+
+		const std::string ext = importPath.extension().string();
+
+		if (ext.compare(".json") == 0)
+			return env.loadJsonModule(importPath.string().c_str());
+
+		return env.loadModule(importPath.string().c_str());
+	}
+
+	/*static*/ v8::MaybeLocal<v8::Promise> Env::importModuleDynamically(v8::Local<v8::Context> context, v8::Local<v8::Data> hostDefinedOptions, v8::Local<v8::Value> resourceName, v8::Local<v8::String> specifier, v8::Local<v8::FixedArray> importAssertions)
+	{
+		const Env& env = Env::fromContext(context);
+
+		v8::Local<v8::Promise::Resolver> resolver;
+		if (!v8::Promise::Resolver::New(context).ToLocal(&resolver))
+			return v8::MaybeLocal<v8::Promise>();
+
+		std::string import = JS::parseString(env, specifier);
+
+		std::replace(import.begin(), import.end(), '\\', '/');
+
+		if (import.compare("native-js") == 0)
+		{
+			env.evaluateImport(env.nativeJSModule_.Get(env.isolate()), resolver);
+			return resolver->GetPromise();
+		}
+
+		// scripts without a path, e.g. from eval, import relative to the app directory
+		const std::string referrerPath = resourceName->IsString() ? JS::parseString(env, resourceName) : std::string();
+
+		std::filesystem::path importPath;
+
+		if (!env.resolveImport(referrerPath, import, importPath))
+		{
+			resolver->Reject(context, v8::Exception::Error(JS::string(env, "Could not resolve import path for " + import + "!"))).ToChecked();
+			return resolver->GetPromise();
+		}
+
+		v8::Local<v8::Module> module;
+
+		if (env.findModule(importPath.string()).ToLocal(&module))
+		{
+			env.evaluateImport(module, resolver);
 		}
-		else if (env.modulesPaths_.contains(id))
+		else if (importPath.extension().string().compare(".json") == 0)
 		{
-			fromPath = (std::filesystem::path(env.modulesPaths_.at(id)) / "..").lexically_normal();
+			if (env.loadJsonModule(importPath.string().c_str()).ToLocal(&module))
+				env.evaluateImport(module, resolver);
+			else
+				resolver->Reject(context, v8::Exception::Error(JS::string(env, "Could not load module " + importPath.string() + "!"))).ToChecked();
 		}
 		else
 		{
-			fromPath = env.app().rootDir();
+			ModuleGraph::import(env, importPath, resolver);
 		}
 
-		if (importPath.is_relative())
-			importPath = fromPath / importPath;
+		return resolver->GetPromise();
+	}
+
+	void Env::evaluateImport(v8::Local<v8::Module> module, v8::Local<v8::Promise::Resolver> resolver) const
+	{
+		v8::TryCatch tryCatcher(isolate());
+
+		v8::Local<v8::Value> result;
 
-		if (!std::filesystem::exists(importPath))
+		if (module->InstantiateModule(context(), importModule).IsNothing() || !module->Evaluate(context()).ToLocal(&result))
 		{
-			bool isValid = false;
-			for (const std::string& t : env.app().appConfig().resolve)
-			{
-				std::filesystem::path checkPath = importPath;
-				checkPath += t;
-				if (std::filesystem::exists(checkPath))
-				{
-					importPath = checkPath;
-					isValid = true;
-					break;
-				}
-			}
+			v8::Local<v8::Value> reason = tryCatcher.HasCaught() ? tryCatcher.Exception() : v8::Exception::Error(JS::string(*this, "Could not instantiate module!")).As<v8::Value>();
+			resolver->Reject(context(), reason).ToChecked();
+			return;
+		}
 
-			if (!isValid)
-			{
-				env.app().logger().warn("Could not resolve import path for ", importPath.string().c_str(), "!");
-				return v8::MaybeLocal<v8::Module>();
-			}
+		storeCodeCache();
+
+		v8::Local<v8::Value> moduleNamespace = module->GetModuleNamespace();
+
+		if (!result->IsPromise())
+		{
+			resolver->Resolve(context(), moduleNamespace).ToChecked();
+			return;
 		}
 
-		const std::string ext = importPath.extension().string();
+		// with top-level await the namespace is only handed out once the evaluation settled
+		v8::Local<v8::Function> getNamespace = v8::Function::New(context(), [](const v8::FunctionCallbackInfo<v8::Value>& args)
+		{
+			args.GetReturnValue().Set(args.Data());
+		}, moduleNamespace).ToLocalChecked();
 
-		v8::MaybeLocal<v8::Module> module;
+		v8::Local<v8::Promise> evaluated;
+		if (result.As<v8::Promise>()->Then(context(), getNamespace).ToLocal(&evaluated))
+			resolver->Resolve(context(), evaluated).ToChecked();
+	}
 
-		if (ext.compare(".json") == 0)
+	bool Env::resolveImport(const std::string& referrerPath, std::string import, std::filesystem::path& resolved) const
+	{
+		std::replace(import.begin(), import.end(), '\\', '/');
+
+		if (import.compare("native-js") == 0)
+			return false;
+
+		std::filesystem::path fromPath;
+
+		if (!std::filesystem::path(import).is_relative())
+		{
+			fromPath = std::filesystem::path("");
+		}
+		else if (!referrerPath.empty())
 		{
-			module = env.loadJsonModule(importPath.string().c_str());
+			fromPath = (std::filesystem::path(referrerPath) / "..").lexically_normal();
 		}
 		else
 		{
-			module = env.loadModule(importPath.string().c_str());
+			fromPath = app().rootDir();
 		}
 
-		return v8::MaybeLocal<v8::Module>(module);
+		if (!app().moduleResolver().resolve(fromPath, import, resolved))
+			return false;
+
+		// the same module reached through different paths has to map to a single key of modules_
+		if (resolved.is_relative())
+			resolved = app().rootDir() / resolved;
+		resolved = resolved.lexically_normal();
+		return true;
+	}
+
+	v8::MaybeLocal<v8::Module> Env::findModule(const std::string& path) const
+	{
+		auto it = modules_.find(path);
+		if (it == modules_.end())
+			return v8::MaybeLocal<v8::Module>();
+		return v8::MaybeLocal<v8::Module>(it->second->Get(isolate()));
+	}
+
+	void Env::addModule(const std::string& path, v8::Local<v8::Module> module) const
+	{
+		modulesPaths_.emplace(module->ScriptId(), path);
+		modules_.emplace(path, new v8::Persistent<v8::Module>(isolate(), module));
+	}
+
+	void Env::storeCodeCache() const
+	{
+		for (const auto& [sourceHash, module] : uncachedModules_)
+		{
+			std::unique_ptr<v8::ScriptCompiler::CachedData> data(v8::ScriptCompiler::CreateCodeCache(module.Get(isolate())->GetUnboundModuleScript()));
+			if (data != nullptr)
+				app().codeCache().put(sourceHash, std::vector<uint8_t>(data->data, data->data + data->length));
+		}
+		uncachedModules_.clear();
 	}
 
 	v8::MaybeLocal<v8::Module> Env::loadJsonModule(const char* filePath) const
@@ -176,24 +374,71 @@ namespace NativeJS::JS
 
 		const std::string path(filePath);
 
-		if (modules_.contains(path))
+		Local<Module> module;
+		if (findModule(path).ToLocal(&module))
+			return module;
+
+		std::shared_ptr<const ModuleSource> source = app().moduleSources().get(path);
+		if (source == nullptr)
+		{
+			app().logger().warn("Could not read module ", path, "!");
 			return v8::MaybeLocal<v8::Module>();
+		}
+
+		// the text is only parsed by the first worker that imports it, or never again once the cache is on disk
+		CodeCache& jsonCache = app().jsonCache();
+		CodeCache::Data data = jsonCache.get(source->hash());
+
+		// an entry starts with the length of its source, so a hash collision or a damaged file is parsed again instead of read
+		const uint64_t sourceLength = source->bytes().size();
+		uint64_t entryLength = 0;
+		if (data != nullptr && data->size() > sizeof(entryLength))
+			memcpy(&entryLength, data->data(), sizeof(entryLength));
+		if (entryLength != sourceLength)
+			data = nullptr;
+
+		if (data == nullptr)
+		{
+			Local<String> jsonString;
+			Local<Value> json;
+			if (!source->toString(isolate()).ToLocal(&jsonString) || !v8::JSON::Parse(context(), jsonString).ToLocal(&json))
+			{
+				std::string exception = tryCatcher.HasCaught() ? JS::parseString(*this, tryCatcher.Exception()) : std::string();
+				app().logger().warn("Could not parse JSON module ", path, "!\n", exception);
+				return v8::MaybeLocal<v8::Module>();
+			}
 
-		std::ifstream is(filePath);
-		std::string jsonString((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+			ValueSerializer serializer(isolate());
+			serializer.WriteHeader();
+			if (serializer.WriteValue(context(), json).IsNothing())
+			{
+				app().logger().warn("Could not serialize JSON module ", path, "!");
+				return v8::MaybeLocal<v8::Module>();
+			}
+
+			// allocated with realloc by the default serializer delegate
+			std::pair<uint8_t*, size_t> buffer = serializer.Release();
+			std::vector<uint8_t> entry(sizeof(sourceLength) + buffer.second);
+			memcpy(entry.data(), &sourceLength, sizeof(sourceLength));
+			memcpy(entry.data() + sizeof(sourceLength), buffer.first, buffer.second);
+			free(buffer.first);
+
+			data = jsonCache.put(source->hash(), std::move(entry));
+		}
 
 		std::vector<v8::Local<v8::String>> exports({ JS::string(*this, "default") });
 
-		Local<Module> module = Module::CreateSyntheticModule(isolate(), JS::string(*this, filePath), exports, [](Local<Context> context, Local<Module> module)
+		module = Module::CreateSyntheticModule(isolate(), JS::string(*this, filePath), exports, [](Local<Context> context, Local<Module> module)
 		{
-			Env& env = *static_cast<Env*>(context->GetIsolate()->GetData(0));
-			module->SetSyntheticModuleExport(context->GetIsolate(), v8::String::NewFromUtf8(context->GetIsolate(), "default").ToLocalChecked(), env.getJsonData(module->GetIdentityHash()).ToLocalChecked());
+			const Env& env = Env::fromContext(context);
+			Local<Value> json;
+			if (!env.getJsonData(module->GetIdentityHash()).ToLocal(&json))
+				return MaybeLocal<Value>();
+			module->SetSyntheticModuleExport(context->GetIsolate(), v8::String::NewFromUtf8(context->GetIsolate(), "default").ToLocalChecked(), json);
 			return MaybeLocal<Value>(v8::True(env.isolate()));
 		});
 
-		Local<Value> json = v8::JSON::Parse(context(), JS::string(*this, jsonString)).ToLocalChecked();
-
-		jsonModules_.emplace(module->GetIdentityHash(), new Persistent<Value>(isolate(), json));
+		jsonModules_.emplace(module->GetIdentityHash(), std::move(data));
 		modules_.emplace(path, new Persistent<Module>(isolate(), module));
 
 		Maybe<bool> result = module->InstantiateModule(context(), Env::importModule);
@@ -212,72 +457,33 @@ namespace NativeJS::JS
 
 	v8::MaybeLocal<v8::Value> Env::getJsonData(const int moduleHash) const
 	{
-		if (jsonModules_.contains(moduleHash))
-			return v8::MaybeLocal<v8::Value>(jsonModules_.at(moduleHash)->Get(isolate()));
-		return v8::MaybeLocal<v8::Value>();
+		auto it = jsonModules_.find(moduleHash);
+		if (it == jsonModules_.end())
+		{
+			isolate()->ThrowException(v8::Exception::Error(JS::string(*this, "Missing data of JSON module!")));
+			return v8::MaybeLocal<v8::Value>();
+		}
+
+		// the serialized bytes are not needed anymore once the module holds the value
+		CodeCache::Data data = std::move(it->second);
+		jsonModules_.erase(it);
+
+		// a failed read throws, so the module is recorded as errored
+		// skips the source length, see loadJsonModule
+		v8::ValueDeserializer deserializer(isolate(), data->data() + sizeof(uint64_t), data->size() - sizeof(uint64_t));
+		if (!deserializer.ReadHeader(context()).FromMaybe(false))
+			return v8::MaybeLocal<v8::Value>();
+		return deserializer.ReadValue(context());
 	}
 
 	v8::MaybeLocal<v8::Module> Env::loadModule(const char* filePath) const
 	{
-		using namespace v8;
-
 		std::filesystem::path path(filePath);
 
 		if (path.is_relative())
-			path = (app().rootDir() / path).lexically_normal();
-
-		std::string p = (path / "..").lexically_normal().string();
-		std::replace(p.begin(), p.end(), '\\', '/');
-		std::string fileName = path.filename().string();
-
-		std::ifstream is(path);
-		std::string code = std::string("const __dirname = \"") + p + "\"; const __filename = \"" + fileName + "\";" + std::string((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
-
-		TryCatch tryCatcher(isolate());
-
-		Local<String> sourceStr = JS::string(*this, code.c_str());
-
-		ScriptOrigin origin(isolate(), JS::string(*this, path.string().c_str()), 0, 0, true, -1, v8::Local<v8::Value>(), false, false, true);
-
-		ScriptCompiler::Source source(sourceStr, origin);
-		MaybeLocal<Module> maybeModule = ScriptCompiler::CompileModule(isolate(), &source);
-
-		if (maybeModule.IsEmpty())
-		{
-			if (tryCatcher.HasCaught())
-			{
-				std::string exception = JS::parseString(*this, tryCatcher.Exception());
-				app().logger().warn("Got exception while loading module ", filePath, "!\n", exception);
-			}
-
-			app().logger().warn("Module ", path.string(), " is empty!");
-			return v8::MaybeLocal<v8::Module>();
-		}
-		else if (tryCatcher.HasCaught())
-		{
-			std::string exception = JS::parseString(*this, tryCatcher.Exception());
-			app().logger().warn("Got exception while loading module ", filePath, "!\n", exception);
-		}
-		else
-		{
-			Local<Module> module = maybeModule.ToLocalChecked();
+			path = app().rootDir() / path;
 
-			modulesPaths_.emplace(module->ScriptId(), path.string());
-			modules_.emplace(path.string(), new Persistent<Module>(isolate(), module));
-
-			Maybe<bool> result = module->InstantiateModule(context(), importModule);
-
-			if (result.IsNothing())
-			{
-				app().logger().warn("Could not instantiate module ", path.string(), "!");
-				return module;
-			}
-			else
-			{
-				module->Evaluate(context());
-				return module;
-			}
-		}
+		return ModuleGraph(*this).load(path.lexically_normal());
 	}
 
 	void Env::loadEntryModule() const
@@ -289,7 +495,11 @@ namespace NativeJS::JS
 		std::filesystem::path path(entry_);
 
 		if (path.is_relative())
-			path = (app().rootDir() / path).lexically_normal();
+			path = app().rootDir() / path;
+		path = path.lexically_normal();
+
+		// the whole graph is compiled on the async pool before the entry wrapper instantiates it
+		ModuleGraph(*this).load(path);
 
 		std::string p = path.string();
 		std::replace(p.begin(), p.end(), '\\', '/');
@@ -327,8 +537,7 @@ namespace NativeJS::JS
 		{
 			Local<Module> module = maybeModule.ToLocalChecked();
 
-			modulesPaths_.emplace(module->ScriptId(), entry);
-			modules_.emplace(entry, new Persistent<Module>(isolate(), module));
+			addModule(entry, module);
 
 			Maybe<bool> result = module->InstantiateModule(context(), importModule);
 
@@ -339,6 +548,7 @@ namespace NativeJS::JS
 			else
 			{
 				module->Evaluate(context());
+				storeCodeCache();
 			}
 		}
 	}
@@ -350,9 +560,26 @@ namespace NativeJS::JS
 
 	v8::Local<v8::Promise> Env::doAsyncWork(WorkCallback work, ResolverCallback resolver, void* data, bool onMainThread) const
 	{
-		AsyncEvent* event = worker_->events_.create<AsyncEvent>(*worker_, work, resolver == nullptr ? defaultAsyncResolver : resolver, data);
-		app().postEvent(event, onMainThread);
-		return event->promise();
+		return postAsyncEvent(createAsyncEvent(work, resolver, data), onMainThread);
+	}
+
+	AsyncEvent* Env::createAsyncEvent(WorkCallback work, ResolverCallback resolver, void* data) const
+	{
+		return worker_->events_.create<AsyncEvent>(*worker_, work, resolver == nullptr ? defaultAsyncResolver : resolver, data);
+	}
+
+	v8::Local<v8::Promise> Env::postAsyncEvent(AsyncEvent* event, bool onMainThread) const
+	{
+		v8::Local<v8::Promise> promise = event->promise();
+
+		// full async queues spill, so this only fails once the pool stopped, the promise is settled anyway
+		if (!app().postEvent(event, onMainThread))
+		{
+			event->rejectPromise(v8::Exception::Error(string(*this, "Could not queue async work!")));
+			worker_->events_.remove(event);
+		}
+
+		return promise;
 	}
 
 	bool Env::doBlockingWork(WorkCallback work, void* data, bool onMainThread) const
@@ -363,8 +590,15 @@ namespace NativeJS::JS
 	v8::Local<v8::Promise> Env::sendMessageToWorker(NativeJS::Worker* receiver, std::string&& message) const
 	{
 		MessageEvent* event = worker_->events_.create<MessageEvent>(worker_, receiver, std::forward<std::string>(message));
-		receiver->postEvent(event);
-		return event->promise();
+		v8::Local<v8::Promise> promise = event->promise();
+
+		if (!receiver->postEvent(event))
+		{
+			event->rejectPromise(v8::Exception::RangeError(string(*this, "Message queue of the receiving worker is full!")));
+			worker_->events_.remove(event);
+		}
+
+		return promise;
 	}
 
 	void Env::emitMessage(MessageEvent& e)
@@ -397,7 +631,7 @@ namespace NativeJS::JS
 			jsWorkers_.erase(worker);
 	}
 
-	bool Env::addTimeout(v8::Local<v8::Function> func, v8::Local<v8::Value> msVal, v8::Local<v8::Value> timeoutObj, v8::Local<v8::Value> loopVal, size_t& index) const
+	bool Env::addTimeout(v8::Local<v8::Function> func, v8::Local<v8::Value> msVal, v8::Local<v8::Value> timeoutObj, v8::Local<v8::Value> loopVal, size_t& id) const
 	{
 		if (!loopVal.IsEmpty() && !loopVal->IsBoolean())
 		{
@@ -414,29 +648,48 @@ namespace NativeJS::JS
 		}
 		const bool loop = loopVal.IsEmpty() ? false : loopVal->BooleanValue(isolate());
 
-		std::chrono::milliseconds resolveTime = Utils::now<std::chrono::milliseconds>() + std::chrono::milliseconds(ms);
+		std::chrono::milliseconds resolveTime = Utils::monotonicNow<std::chrono::milliseconds>() + std::chrono::milliseconds(ms);
 
-		index = timeouts_.alloc(*this, resolveTime, loop);
+		const size_t index = timeouts_.alloc(*this, resolveTime, loop);
 		Timeout* t = timeouts_.at(index);
-		t->setIndex(index);
+		id = timeouts_.handle(index).id();
+		t->setId(id);
 		t->wrap(timeoutObj);
-		app().postEvent(worker_->events_.create<TimeoutEvent>(*this, index, resolveTime, ms, loop), true);
+
+		const std::chrono::milliseconds duration(ms);
+		worker_->timers_.schedule(t->timer(), duration, loop ? std::max(duration, std::chrono::milliseconds(1)) : std::chrono::milliseconds(0));
 
 		return true;
 	}
 
-	void Env::removeTimeout(size_t index) const
+	bool Env::removeTimeout(size_t id) const
 	{
-		// timeouts_.free(index);
-		app().postEvent(worker_->events_.create<TimeoutEvent>(*this, index, TimeoutEvent::Type::CANCEL), true);
+		const auto handle = decltype(timeouts_)::Handle::fromId(id);
+		Timeout* t = timeouts_.get(handle);
+		if (t == nullptr || t->isTerminated())
+			return false;
+
+		worker_->timers_.cancel(t->timer());
+
+		// releases the callback and the receiver, a later cancel or resolve with the id finds nothing
+		timeouts_.free(handle);
+
+		return true;
 	}
 
-	void Env::resolveTimeout(const size_t index) const
+	void Env::resolveTimeout(const size_t id) const
 	{
-		Timeout* timeout = timeouts_.at(index);
+		const auto handle = decltype(timeouts_)::Handle::fromId(id);
+		Timeout* timeout = timeouts_.get(handle);
+		if (timeout == nullptr || timeout->isTerminated())
+			return;
+
+		const bool loop = timeout->loop();
 		timeout->resolve();
-		if (!timeout->loop())
-			timeouts_.free(index);
+
+		// the callback may have cleared the timeout itself, freeing through the handle is a no-op then
+		if (!loop)
+			timeouts_.free(handle);
 	}
 
 	bool Env::isJsAppInitialized() const
@@ -453,6 +706,7 @@ namespace NativeJS::JS
 	{
 		jsApp_.wrap(value);
 		isJsAppInitialized_ = true;
+		app().subscriptions().subscribe(worker_, WM_QUIT);
 	}
 
 	v8::Local<v8::Value> Env::createEvent(Event* event) const
@@ -486,4 +740,43 @@ namespace NativeJS::JS
 	{
 		return worker == std::addressof(this->worker());
 	}
-}
\ No newline at end of file
+
+	size_t Env::nearHeapLimit(void* data, size_t currentHeapLimit, size_t initialHeapLimit)
+	{
+		Env& env = *static_cast<Env*>(data);
+
+		// runs inside a GC, so no JS and no allocations on the JS heap
+		if (currentHeapLimit > initialHeapLimit || env.worker().heapLimits().onNearLimit == HeapLimits::Action::Terminate)
+		{
+			// V8 clears the termination once the script unwound, so the worker checks this instead
+			env.mustTerminate_.store(true, std::memory_order::release);
+			env.isolate()->TerminateExecution();
+		}
+
+		env.isNearHeapLimit_.store(true, std::memory_order::release);
+
+		// the headroom lets a terminated script unwind without running out of memory
+		return currentHeapLimit + currentHeapLimit * NEAR_HEAP_LIMIT_HEADROOM_PERCENT / 100;
+	}
+
+	bool Env::handleNearHeapLimit() const
+	{
+		if (!isNearHeapLimit_.exchange(false, std::memory_order::acq_rel))
+			return true;
+
+		if (mustTerminate_.load(std::memory_order::acquire))
+			return false;
+
+		switch (worker().heapLimits().onNearLimit)
+		{
+			case HeapLimits::Action::Collect:
+				isolate()->LowMemoryNotification();
+				return true;
+			case HeapLimits::Action::Emit:
+				jsSelfWorker_.emitHeapLimit();
+				return true;
+			default:
+				return false;
+		}
+	}
+}
@@ -26,21 +26,17 @@ namespace NativeJS
 
 		JS_CLASS_METHOD_IMPL(AppClass::onInit)
 		{
-			v8::Local<v8::Array> arr = v8::Array::New(env.isolate(), 2);
-			arr->Set(env.context(), 0, args[0]);
-			arr->Set(env.context(), 1, args[1]);
-			v8::Persistent<v8::Array>* p = new v8::Persistent<v8::Array>(env.isolate(), arr);
-			v8::Local<v8::Promise> promise = env.doAsyncWork([](Event* e) { }, [](const WorkEvent& e)
+			v8::Local<v8::Promise> promise = env.doAsyncTask([](NativeJS::Worker&) { }, [
+				ctor = v8::Global<v8::Function>(env.isolate(), args[0].As<v8::Function>()),
+				appArgs = v8::Global<v8::Value>(env.isolate(), args[1])
+			](const WorkEvent& e)
 			{
 				const Env& env = e.worker().env();
-				v8::Persistent<v8::Array>* ptr = e.data<v8::Persistent<v8::Array>>();
-				v8::Local<v8::Array> args = ptr->Get(env.isolate());
-				v8::Local<v8::Function> ctor = args->Get(env.context(), 0).ToLocalChecked().As<v8::Function>();
-				v8::Local<v8::Value> appObj = ctor->CallAsConstructor(env.context(), 0, nullptr).ToLocalChecked();
+				v8::Local<v8::Value> appObj = ctor.Get(env.isolate())->CallAsConstructor(env.context(), 0, nullptr).ToLocalChecked();
 				env.initializeJSApp(appObj);
 				e.resolvePromise(appObj);
-				env.jsApp().onLoad({ args->Get(env.context(), 1).ToLocalChecked() });
-			}, p, true);
+				env.jsApp().onLoad({ appArgs.Get(env.isolate()) });
+			}, true);
 			args.GetReturnValue().Set(promise);
 		}
 
@@ -58,8 +54,8 @@ namespace NativeJS
 
 		JS_CREATE_CLASS(AppClass)
 		{
-			builder.setStaticMethod("initialize", onInit, this);
-			builder.setStaticMethod("get", onGet, this);
+			builder.setStaticMethod("initialize", onInit);
+			builder.setStaticMethod("get", onGet);
 			builder.setMethod("onLoad");
 			builder.setMethod("onTick");
 			builder.setMethod("onQuit");
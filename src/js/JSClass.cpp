@@ -45,11 +45,11 @@ namespace NativeJS::JS
 
 	void ClassBuilder::emptyFunction(const v8::FunctionCallbackInfo<v8::Value>& args) { }
 
-	ClassBuilder::ClassBuilder(const Env& env, void* self) :
-		self_(self),
+	// the templates carry no per-env data (e.g. an External of the class), so they can be serialized into the startup snapshot
+	ClassBuilder::ClassBuilder(const Env& env) :
 		env_(env),
 		internalFieldCount_(0),
-		template_(v8::FunctionTemplate::New(env_.isolate(), nullptr, v8::External::New(env_.isolate(), self)))
+		template_(v8::FunctionTemplate::New(env_.isolate()))
 	{
 
 	}
@@ -63,20 +63,10 @@ namespace NativeJS::JS
 	const ClassBuilder& ClassBuilder::setStaticMethod(const char* name, v8::FunctionCallback callback, v8::Local<v8::Value> data) const
 	{
 		v8::Isolate* isolate = env_.isolate();
-
-		if (data.IsEmpty())
-			data = v8::External::New(isolate, self_);
-
 		template_->Set(isolate, name, v8::FunctionTemplate::New(isolate, callback, data));
 		return *this;
 	}
 
-	const ClassBuilder& ClassBuilder::setStaticMethod(const char* name, v8::FunctionCallback callback, void* data) const
-	{
-		setStaticMethod(name, callback, v8::External::New(env_.isolate(), data));
-		return *this;
-	}
-
 	const ClassBuilder& ClassBuilder::set(const char* key, v8::Local<v8::Value> val, bool readonly, bool isPrivate) const
 	{
 		if (isPrivate)
@@ -88,18 +78,10 @@ namespace NativeJS::JS
 
 	const ClassBuilder& ClassBuilder::setMethod(const char* name, v8::FunctionCallback callback, v8::Local<v8::Value> data, v8::PropertyAttribute attr) const
 	{
-		if (data.IsEmpty())
-			data = v8::External::New(env_.isolate(), self_);
 		template_->PrototypeTemplate()->Set(env_.isolate(), name, v8::FunctionTemplate::New(env_.isolate(), callback, data), attr);
 		return *this;
 	}
 
-	const ClassBuilder& ClassBuilder::setMethod(const char* name, v8::FunctionCallback callback, void* data) const
-	{
-		setMethod(name, callback, v8::External::New(env_.isolate(), data));
-		return *this;
-	}
-
 	const ClassBuilder& ClassBuilder::setInternalFieldCount(const int count) const
 	{
 		template_->InstanceTemplate()->SetInternalFieldCount(count);
@@ -114,12 +96,6 @@ namespace NativeJS::JS
 		return *this;
 	}
 
-	const ClassBuilder& ClassBuilder::setConstructor(v8::FunctionCallback callback, void* data) const
-	{
-		template_->SetCallHandler(callback, v8::External::New(env_.isolate(), data));
-		return *this;
-	}
-
 	v8::Local<v8::Function> ClassBuilder::getClass() const
 	{
 		return template_->GetFunction(env_.context()).ToLocalChecked();
@@ -132,17 +108,27 @@ namespace NativeJS::JS
 
 	}
 
-	Class::~Class() { }
+	Class::~Class()
+	{
+		persistent_.Reset();
+	}
 
 	void Class::initialize()
 	{
 		if (!persistent_.IsEmpty())
 			throw std::runtime_error("Class is already initialized!");
-		ClassBuilder builder(env, this);
+		ClassBuilder builder(env);
 		create(builder);
 		persistent_.Reset(env.isolate(), builder.getClass());
 	}
 
+	void Class::restore(v8::Local<v8::Function> jsClass)
+	{
+		if (!persistent_.IsEmpty())
+			throw std::runtime_error("Class is already initialized!");
+		persistent_.Reset(env.isolate(), jsClass);
+	}
+
 	v8::Local<v8::Function> Class::getClass() const
 	{
 		assert(!persistent_.IsEmpty());
@@ -26,4 +26,29 @@ namespace NativeJS::JS
 			isInitialized_ = true;
 		}
 	}
+
+	void EnvClasses::serialize(v8::SnapshotCreator& creator, v8::Local<v8::Context> context) const
+	{
+		assert(isInitialized_);
+
+		for (const Class* jsClass : list())
+			creator.AddData(context, jsClass->getClass());
+	}
+
+	void EnvClasses::deserialize(v8::Local<v8::Context> context)
+	{
+		if (isInitialized_)
+			return;
+
+		size_t index = 0;
+		for (Class* jsClass : list())
+		{
+			v8::Local<v8::Function> fn;
+			if (!context->GetDataFromSnapshotOnce<v8::Function>(index++).ToLocal(&fn))
+				throw std::runtime_error("The startup snapshot does not match the native-js classes!");
+			jsClass->restore(fn);
+		}
+
+		isInitialized_ = true;
+	}
 }
\ No newline at end of file
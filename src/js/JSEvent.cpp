@@ -34,8 +34,8 @@ namespace NativeJS::JS
 
 	JS_CREATE_CLASS(EventClass)
 	{
-		builder.setConstructor(ctor, this);
+		builder.setConstructor(ctor);
 		builder.setInternalFieldCount(1);
-		builder.setMethod("cancel", cancel, this);
+		builder.setMethod("cancel", cancel);
 	}
 }
\ No newline at end of file
@@ -3,16 +3,35 @@
 #include "js/Env.hpp"
 #include "js/JSObject.hpp"
 #include "js/JSUtils.hpp"
+#include "js/ArrayBufferAllocator.hpp"
 #include "App.hpp"
 
 namespace NativeJS::JS::Process
 {
+	namespace
+	{
+		void arrayBuffers(const v8::FunctionCallbackInfo<v8::Value>& args)
+		{
+			const Env& env = Env::fromArgs(args);
+			const ArrayBufferAllocator::Stats stats = env.arrayBufferAllocator().stats();
+
+			Object result(env);
+			result.set("liveBytes", JS::number(env, static_cast<double>(stats.liveBytes)));
+			result.set("peakBytes", JS::number(env, static_cast<double>(stats.peakBytes)));
+			result.set("totalBytes", JS::number(env, static_cast<double>(stats.totalBytes)));
+			result.set("allocations", JS::number(env, static_cast<double>(stats.allocations)));
+			result.set("pooledBytes", JS::number(env, static_cast<double>(env.app().arrayBufferPool().pooledBytes())));
+			args.GetReturnValue().Set(*result);
+		}
+	}
+
 	void expose(const Env& env, Object& global)
 	{
 		std::vector<const char*> args = env.app().getAppArgs();
 
 		Object process(env);
 		process.set("args", mapStringArray(env, args), v8::PropertyAttribute::ReadOnly);
+		process.set("arrayBuffers", arrayBuffers);
 		global.set("process", *process);
 	}
-}
\ No newline at end of file
+}
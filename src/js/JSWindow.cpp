@@ -14,11 +14,17 @@ namespace NativeJS::JS
 		loadMethod(onLoad_, "onLoad");
 		loadMethod(onClose_, "onClose");
 		loadMethod(onClosed_, "onClosed");
+		loadMethod(onMouseMove_, "onMouseMove");
+		loadMethod(onResize_, "onResize");
+		loadMethod(onScroll_, "onScroll");
 	}
 
 	JS_METHOD_IMPL(Window::onLoad);
 	JS_METHOD_IMPL(Window::onClose);
 	JS_METHOD_IMPL(Window::onClosed);
+	JS_METHOD_IMPL(Window::onMouseMove);
+	JS_METHOD_IMPL(Window::onResize);
+	JS_METHOD_IMPL(Window::onScroll);
 
 	JS_CLASS_METHOD_IMPL(WindowClass::onCreate)
 	{
@@ -40,35 +46,17 @@ namespace NativeJS::JS
 			}
 			else
 			{
-				struct AsyncInfo
+				v8::Local<v8::Promise> promise = env.doAsyncTask([title = parseString(env, args[1])](NativeJS::Worker& worker)
 				{
-					NativeJS::Window* win = nullptr;
-					std::string title;
-					v8::Persistent<v8::Function> jsClass;
-				};
-
-				// TODO: Replace the new AsyncInfo with a custom allocated one
-				AsyncInfo* info = new AsyncInfo();
-				info->title = parseString(env, args[1]);
-				info->jsClass.Reset(env.isolate(), args[0].As<v8::Function>());
-
-				v8::Local<v8::Promise> promise = env.doAsyncWork([](Event* event)
-				{
-					AsyncEvent* e = static_cast<AsyncEvent*>(event);
-					AsyncInfo* info = e->data<AsyncInfo>();
-					const Env& env = e->worker().env();
-					info->win = env.app().windowManager().create(info->title);
-
-				}, [](const WorkEvent& event)
+					return worker.app().windowManager().create(title);
+				}, [jsClass = v8::Global<v8::Function>(env.isolate(), args[0].As<v8::Function>())](const WorkEvent& event, NativeJS::Window* win)
 				{
 					const Env& env = event.worker().env();
-					AsyncInfo* info = event.data<AsyncInfo>();
-					std::vector<v8::Local<v8::Value>> winArgs = { v8::External::New(env.isolate(), info->win) };
-					v8::Local<v8::Value> jsWin = info->jsClass.Get(env.isolate())->CallAsConstructor(env.context(), 1, winArgs.data()).ToLocalChecked();
-					info->win->registerJsObject(std::addressof(event.worker()), jsWin);
+					std::vector<v8::Local<v8::Value>> winArgs = { v8::External::New(env.isolate(), win) };
+					v8::Local<v8::Value> jsWin = jsClass.Get(env.isolate())->CallAsConstructor(env.context(), 1, winArgs.data()).ToLocalChecked();
+					win->registerJsObject(std::addressof(event.worker()), jsWin);
 					event.resolvePromise(jsWin);
-					delete info;
-				}, info, true);
+				}, true);
 
 				args.GetReturnValue().Set(promise);
 			}
@@ -123,6 +111,9 @@ namespace NativeJS::JS
 		builder.setMethod("close");
 		builder.setMethod("onClose");
 		builder.setMethod("onClosed");
+		builder.setMethod("onMouseMove");
+		builder.setMethod("onResize");
+		builder.setMethod("onScroll");
 		builder.setInternalFieldCount(1);
 	}
 }
\ No newline at end of file
@@ -10,6 +10,17 @@ namespace NativeJS
 {
 	namespace JS
 	{
+		static void callListeners(const Env& env, v8::Local<v8::Array> listeners)
+		{
+			const size_t l = listeners->Length();
+
+			for (size_t i = 0; i < l; i++)
+			{
+				v8::Local<v8::Function> fn = listeners->Get(env.context(), i).ToLocalChecked().As<v8::Function>();
+				fn->Call(env.context(), fn, 0, nullptr).ToLocalChecked();
+			}
+		}
+
 		Worker::Worker(const Env& env) : ObjectWrapper(env) { }
 		Worker::~Worker() { }
 
@@ -27,6 +38,10 @@ namespace NativeJS
 			{
 				puts("could not set listeners!");
 			}
+
+			v8::Local<v8::Value> heapLimitListenersVal;
+			if (getFromObject(env_, value(), "heapLimitListeners_", heapLimitListenersVal) && heapLimitListenersVal->IsArray())
+				heapLimitListeners_.Reset(env_.isolate(), heapLimitListenersVal.As<v8::Array>());
 		}
 
 		void Worker::emitMessage(const std::string& message)
@@ -39,21 +54,18 @@ namespace NativeJS
 				{
 					v8::Local<v8::Value> arrVal = maybeListeners.ToLocalChecked();
 					if (arrVal->IsArray())
-					{
-						v8::Local<v8::Array> arr = arrVal.As<v8::Array>();
-						const size_t l = arr->Length();
-
-						for (size_t i = 0; i < l; i++)
-						{
-							v8::Local<v8::Function> fn = arr->Get(env_.context(), i).ToLocalChecked().As<v8::Function>();
-							fn->Call(env_.context(), fn, 0, nullptr).ToLocalChecked();
-						}
-					}
+						callListeners(env_, arrVal.As<v8::Array>());
 				}
 			}
 
 		}
 
+		void Worker::emitHeapLimit()
+		{
+			if (!heapLimitListeners_.IsEmpty())
+				callListeners(env_, heapLimitListeners_.Get(env_.isolate()));
+		}
+
 		JS_METHOD_IMPL(Worker::send);
 		JS_METHOD_IMPL(Worker::terminate);
 
@@ -69,6 +81,7 @@ namespace NativeJS
 			{
 				NativeJS::Worker* w = parseExternal<NativeJS::Worker>(env, args[0]);
 				args.This()->Set(env.context(), string(env, "listeners_"), v8::Object::New(env.isolate()));
+				args.This()->Set(env.context(), string(env, "heapLimitListeners_"), v8::Array::New(env.isolate()));
 				args.This()->SetInternalField(0, args[0]);
 			}
 			else if (args[0]->IsString())
@@ -78,19 +91,27 @@ namespace NativeJS
 					std::string entry;
 					NativeJS::Worker* worker = nullptr;
 					NativeJS::Worker* parentWorker = nullptr;
+					HeapLimits heapLimits;
 				};
 
 				Info info;
 				info.entry = parseString(env, args[0]);
 				info.parentWorker = std::addressof(env.worker());
+				info.heapLimits = env.app().appConfig().heap;
+
+				// new Worker(entry, { heap: { maxOldGenerationMb, maxYoungGenerationMb, codeRangeMb, onNearLimit } })
+				v8::Local<v8::Value> heapVal;
+				if (l > 1 && args[1]->IsObject() && getFromObject(env, args[1], "heap", heapVal))
+					info.heapLimits.load(env, heapVal);
 
 				args.This()->Set(env.context(), string(env, "listeners_"), v8::Object::New(env.isolate()));
+				args.This()->Set(env.context(), string(env, "heapLimitListeners_"), v8::Array::New(env.isolate()));
 
 				env.doBlockingWork([](Event* event)
 				{
 					BlockingEvent* e = static_cast<BlockingEvent*>(event);
 					Info* info = e->data<Info>();
-					info->worker = e->worker().app().createWorker(std::move(info->entry), info->parentWorker);
+					info->worker = e->worker().app().createWorker(std::move(info->entry), info->parentWorker, &info->heapLimits);
 				}, &info, true);
 
 				if (info.worker != nullptr)
@@ -225,6 +246,25 @@ namespace NativeJS
 			}
 		}
 
+		JS_CLASS_METHOD_IMPL(WorkerClass::onHeapLimit)
+		{
+			v8::Local<v8::Value> listenersVal;
+
+			if (args.Length() == 0 || !args[0]->IsFunction())
+			{
+				env.throwException("First argument is not a function!");
+			}
+			else if (!getFromObject(env, args.This(), "heapLimitListeners_", listenersVal) || !listenersVal->IsArray())
+			{
+				env.throwException("Could not get heap limit listeners!");
+			}
+			else
+			{
+				v8::Local<v8::Array> listeners = listenersVal.As<v8::Array>();
+				listeners->Set(env.context(), listeners->Length(), args[0]);
+			}
+		}
+
 		JS_CREATE_CLASS(WorkerClass)
 		{
 			builder.setStaticMethod("getParentWorker", getParentWorker);
@@ -232,6 +272,7 @@ namespace NativeJS
 			builder.setMethod("terminate", terminate, v8::Local<v8::Value>(), v8::PropertyAttribute::ReadOnly);
 			builder.setMethod("send", send, v8::Local<v8::Value>(), v8::PropertyAttribute::ReadOnly);
 			builder.setMethod("on", onMessage, v8::Local<v8::Value>(), v8::PropertyAttribute::ReadOnly);
+			builder.setMethod("onHeapLimit", onHeapLimit, v8::Local<v8::Value>(), v8::PropertyAttribute::ReadOnly);
 			builder.setInternalFieldCount(1);
 		}
 	}
@@ -0,0 +1,351 @@
+#include "framework.hpp"
+#include "js/ModuleGraph.hpp"
+#include "js/Env.hpp"
+#include "js/JSUtils.hpp"
+#include "App.hpp"
+#include "Worker.hpp"
+#include "constants.hpp"
+
+namespace NativeJS::JS
+{
+	class ModuleGraph::SourceStream : public v8::ScriptCompiler::ExternalSourceStream
+	{
+	public:
+		SourceStream(std::shared_ptr<const ModuleSource> source) : source_(std::move(source)), offset_(0) { }
+
+		size_t GetMoreData(const uint8_t** src) override
+		{
+			// V8 takes over every chunk, so the shared source is copied a chunk at a time while it is parsed
+			const std::string_view bytes = source_->bytes();
+			const size_t length = std::min(bytes.size() - offset_, MODULE_STREAM_CHUNK_SIZE);
+			if (length == 0)
+				return 0;
+
+			uint8_t* chunk = new uint8_t[length];
+			memcpy(chunk, bytes.data() + offset_, length);
+			offset_ += length;
+			*src = chunk;
+			return length;
+		}
+
+	private:
+		std::shared_ptr<const ModuleSource> source_;
+		size_t offset_;
+	};
+
+	struct ModuleGraph::PendingModule
+	{
+		std::string path;
+		std::shared_ptr<const ModuleSource> source;
+		CodeCache::Data cachedData;
+		std::unique_ptr<v8::ScriptCompiler::StreamedSource> streamedSource;
+		std::unique_ptr<v8::ScriptCompiler::ScriptStreamingTask> task;
+		BlockingEvent* event;
+	};
+
+	/*static*/ void ModuleGraph::import(const Env& env, const std::filesystem::path& path, v8::Local<v8::Promise::Resolver> resolver)
+	{
+		// the last module to be advanced settles the import and drops the graph
+		ModuleGraph* graph = new ModuleGraph(env);
+		env.imports_.emplace(graph, graph);
+		graph->importPath_ = path.string();
+		graph->resolver_.Reset(env.isolate(), resolver);
+		graph->fetch(path);
+		graph->continueImport();
+	}
+
+	/*static*/ void ModuleGraph::read(PendingModule& pending, NativeJS::App& app)
+	{
+		// shared with every other worker that loads the file
+		pending.source = app.moduleSources().get(pending.path);
+		if (pending.source != nullptr)
+			pending.cachedData = app.codeCache().get(pending.source->hash());
+	}
+
+	ModuleGraph::ModuleGraph(const Env& env) :
+		env_(env),
+		fetched_(),
+		ready_(),
+		streaming_(),
+		importPath_(),
+		resolver_(),
+		exception_(),
+		posted_(),
+		isCanceled_(false),
+		mutex_(),
+		cv_(),
+		runningCount_(0)
+	{ }
+
+	ModuleGraph::~ModuleGraph()
+	{
+		// the tasks read their StreamedSource until they are done
+		while (!streaming_.empty())
+			waitForStreaming();
+
+		cancel();
+	}
+
+	void ModuleGraph::cancel()
+	{
+		isCanceled_.store(true, std::memory_order::release);
+
+		std::unique_lock lk(mutex_);
+		cv_.wait(lk, [&]() { return runningCount_ == 0; });
+	}
+
+	v8::MaybeLocal<v8::Module> ModuleGraph::load(const std::filesystem::path& path)
+	{
+		fetch(path);
+
+		while (!ready_.empty() || !streaming_.empty())
+		{
+			if (ready_.empty())
+				waitForStreaming();
+
+			// compiling a module fetches its imports, which queues more work
+			std::unique_ptr<PendingModule> pending = std::move(ready_.front());
+			ready_.pop_front();
+			compile(*pending);
+		}
+
+		return env_.findModule(path.string());
+	}
+
+	void ModuleGraph::fetch(const std::filesystem::path& path)
+	{
+		std::string key = path.string();
+
+		if (!env_.findModule(key).IsEmpty() || !fetched_.emplace(key).second)
+			return;
+
+		// json modules are cheap to parse and are loaded when they are instantiated
+		if (path.extension() == ".json")
+			return;
+
+		std::unique_ptr<PendingModule> pending = std::make_unique<PendingModule>();
+		pending->path = std::move(key);
+		pending->event = nullptr;
+
+		if (isAsync())
+		{
+			post(std::move(pending), read);
+			return;
+		}
+
+		read(*pending, env_.app());
+		advance(std::move(pending));
+	}
+
+	void ModuleGraph::advance(std::unique_ptr<PendingModule> pending)
+	{
+		if (pending->source == nullptr)
+		{
+			env_.app().logger().warn("Could not read module ", pending->path, "!");
+			return;
+		}
+
+		// deserializing a code cache entry is cheaper than handing the module to another thread
+		if (pending->task != nullptr || pending->cachedData != nullptr)
+		{
+			ready_.emplace_back(std::move(pending));
+			return;
+		}
+
+		const v8::ScriptCompiler::StreamedSource::Encoding encoding = pending->source->isOneByte() ? v8::ScriptCompiler::StreamedSource::ONE_BYTE : v8::ScriptCompiler::StreamedSource::TWO_BYTE;
+		pending->streamedSource = std::make_unique<v8::ScriptCompiler::StreamedSource>(std::make_unique<SourceStream>(pending->source), encoding);
+		pending->task.reset(v8::ScriptCompiler::StartStreaming(env_.isolate(), pending->streamedSource.get(), v8::ScriptType::kModule));
+
+		if (isAsync())
+		{
+			post(std::move(pending), [](PendingModule& pending, NativeJS::App&) { pending.task->Run(); });
+			return;
+		}
+
+		pending->event = env_.worker().postBlockingWork([](Event* e)
+		{
+			e->data<v8::ScriptCompiler::ScriptStreamingTask>()->Run();
+		}, pending->task.get());
+
+		if (pending->event == nullptr)
+		{
+			// the pool stopped, the module is parsed right here instead
+			pending->task->Run();
+			ready_.emplace_back(std::move(pending));
+			return;
+		}
+
+		streaming_.emplace_back(std::move(pending));
+	}
+
+	void ModuleGraph::post(std::unique_ptr<PendingModule> pending, void (*work)(PendingModule& pending, NativeJS::App& app))
+	{
+		PendingModule* target = pending.get();
+
+		AsyncEvent* event = env_.createAsyncEvent(nullptr, nullptr, nullptr);
+		event->emplaceTask([this, target, work](NativeJS::Worker& worker)
+		{
+			// a canceled graph only waits for the work to return, the isolate may be about to go away
+			if (!isCanceled_.load(std::memory_order::acquire))
+				work(*target, worker.app());
+
+			std::lock_guard lk(mutex_);
+			runningCount_--;
+			cv_.notify_all();
+		}, [this, target](const WorkEvent&)
+		{
+			auto node = posted_.extract(target);
+			advance(std::move(node.mapped()));
+			continueImport();
+		});
+
+		{
+			std::lock_guard lk(mutex_);
+			runningCount_++;
+		}
+
+		if (!env_.app().postEvent(event, false))
+		{
+			{
+				std::lock_guard lk(mutex_);
+				runningCount_--;
+			}
+
+			// the pool stopped, the work is done right here instead
+			env_.worker().removeEvent(event);
+			work(*pending, env_.app());
+			advance(std::move(pending));
+			return;
+		}
+
+		posted_.emplace(target, std::move(pending));
+	}
+
+	void ModuleGraph::compile(PendingModule& pending)
+	{
+		using namespace v8;
+
+		Isolate* isolate = env_.isolate();
+
+		// a dynamic import can race with a static one for the same module
+		if (!env_.findModule(pending.path).IsEmpty())
+			return;
+
+		TryCatch tryCatcher(isolate);
+
+		Local<String> sourceStr;
+		if (!pending.source->toString(isolate).ToLocal(&sourceStr))
+		{
+			env_.app().logger().warn("Module ", pending.path, " is too large!");
+			return;
+		}
+
+		ScriptOrigin origin(isolate, JS::string(env_, pending.path.c_str()), 0, 0, true, -1, v8::Local<v8::Value>(), false, false, true);
+
+		MaybeLocal<Module> maybeModule;
+		bool isCacheStale = env_.app().codeCache().isEnabled();
+
+		if (pending.task != nullptr)
+		{
+			maybeModule = ScriptCompiler::CompileModule(env_.context(), pending.streamedSource.get(), sourceStr, origin);
+		}
+		else
+		{
+			// keeps the bytes alive while V8 reads them, the CachedData itself does not own them
+			ScriptCompiler::Source source(sourceStr, origin, new ScriptCompiler::CachedData(pending.cachedData->data(), static_cast<int>(pending.cachedData->size()), ScriptCompiler::CachedData::BufferNotOwned));
+			maybeModule = ScriptCompiler::CompileModule(isolate, &source, ScriptCompiler::kConsumeCodeCache);
+			isCacheStale = isCacheStale && source.GetCachedData()->rejected;
+		}
+
+		if (tryCatcher.HasCaught())
+		{
+			std::string exception = JS::parseString(env_, tryCatcher.Exception());
+			env_.app().logger().warn("Got exception while loading module ", pending.path, "!\n", exception);
+
+			if (isAsync() && exception_.IsEmpty())
+				exception_.Reset(isolate, tryCatcher.Exception());
+		}
+
+		Local<Module> module;
+		if (!maybeModule.ToLocal(&module))
+		{
+			env_.app().logger().warn("Module ", pending.path, " is empty!");
+			return;
+		}
+
+		env_.addModule(pending.path, module);
+
+		// the cache is created once the graph ran, so the functions that already ran are compiled into it as well
+		if (isCacheStale)
+			env_.uncachedModules_.emplace_back(pending.source->hash(), v8::Global<v8::Module>(isolate, module));
+
+		fetchImports(pending.path, module);
+	}
+
+	void ModuleGraph::fetchImports(const std::string& path, v8::Local<v8::Module> module)
+	{
+		v8::Local<v8::FixedArray> requests = module->GetModuleRequests();
+
+		for (int i = 0; i < requests->Length(); i++)
+		{
+			v8::Local<v8::ModuleRequest> request = requests->Get(env_.context(), i).As<v8::ModuleRequest>();
+			const std::string import = JS::parseString(env_, request->GetSpecifier());
+
+			// unresolved imports are reported when the module is instantiated
+			std::filesystem::path importPath;
+			if (env_.resolveImport(path, import, importPath))
+				fetch(importPath);
+		}
+	}
+
+	void ModuleGraph::waitForStreaming()
+	{
+		std::vector<BlockingEvent*> events;
+		events.reserve(streaming_.size());
+		for (const std::unique_ptr<PendingModule>& pending : streaming_)
+			events.push_back(pending->event);
+
+		env_.worker().waitForBlockingWork(events);
+
+		for (auto it = streaming_.begin(); it != streaming_.end();)
+		{
+			if ((*it)->event->isDone())
+			{
+				env_.worker().removeEvent((*it)->event);
+				(*it)->event = nullptr;
+				ready_.emplace_back(std::move(*it));
+				it = streaming_.erase(it);
+			}
+			else
+			{
+				it++;
+			}
+		}
+	}
+
+	void ModuleGraph::continueImport()
+	{
+		while (!ready_.empty())
+		{
+			std::unique_ptr<PendingModule> pending = std::move(ready_.front());
+			ready_.pop_front();
+			compile(*pending);
+		}
+
+		if (!posted_.empty())
+			return;
+
+		v8::Local<v8::Promise::Resolver> resolver = resolver_.Get(env_.isolate());
+		v8::Local<v8::Module> module;
+
+		if (!exception_.IsEmpty())
+			resolver->Reject(env_.context(), exception_.Get(env_.isolate())).ToChecked();
+		else if (env_.findModule(importPath_).ToLocal(&module))
+			env_.evaluateImport(module, resolver);
+		else
+			resolver->Reject(env_.context(), v8::Exception::Error(JS::string(env_, "Could not load module " + importPath_ + "!"))).ToChecked();
+
+		// destroys the graph
+		env_.imports_.erase(this);
+	}
+}
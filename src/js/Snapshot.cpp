@@ -0,0 +1,102 @@
+#include "framework.hpp"
+#include "js/Snapshot.hpp"
+#include "js/Env.hpp"
+#include "js/JSConsole.hpp"
+#include "js/JSWindow.hpp"
+#include "js/JSApp.hpp"
+#include "js/JSEvent.hpp"
+#include "js/JSWorker.hpp"
+#include "js/Timeout.hpp"
+#include "App.hpp"
+
+namespace NativeJS::JS
+{
+	/*static*/ const intptr_t* Snapshot::externalReferences()
+	{
+		static const intptr_t references[] = {
+			reinterpret_cast<intptr_t>(&ClassBuilder::emptyFunction),
+			reinterpret_cast<intptr_t>(&Console::log),
+			reinterpret_cast<intptr_t>(&Console::clear),
+			reinterpret_cast<intptr_t>(&WindowClass::onCreate),
+			reinterpret_cast<intptr_t>(&WindowClass::ctor),
+			reinterpret_cast<intptr_t>(&WindowClass::onShow),
+			reinterpret_cast<intptr_t>(&AppClass::onInit),
+			reinterpret_cast<intptr_t>(&AppClass::onGet),
+			reinterpret_cast<intptr_t>(&EventClass::ctor),
+			reinterpret_cast<intptr_t>(&EventClass::cancel),
+			reinterpret_cast<intptr_t>(&WorkerClass::getParentWorker),
+			reinterpret_cast<intptr_t>(&WorkerClass::ctor),
+			reinterpret_cast<intptr_t>(&WorkerClass::terminate),
+			reinterpret_cast<intptr_t>(&WorkerClass::send),
+			reinterpret_cast<intptr_t>(&WorkerClass::onMessage),
+			reinterpret_cast<intptr_t>(&WorkerClass::onHeapLimit),
+			reinterpret_cast<intptr_t>(&TimeoutClass::setTimeoutWrapper),
+			reinterpret_cast<intptr_t>(&TimeoutClass::setIntervalWrapper),
+			reinterpret_cast<intptr_t>(&TimeoutClass::ctor),
+			reinterpret_cast<intptr_t>(&TimeoutClass::cancel),
+			0
+		};
+		return references;
+	}
+
+	/*static*/ bool Snapshot::build(NativeJS::App& app, const std::filesystem::path& path)
+	{
+		Logger& logger = app.logger();
+
+		v8::SnapshotCreator creator(externalReferences());
+
+		{
+			logger.debug("Building the startup snapshot...");
+			// the env has to be gone before the blob is created, so none of its handles are left
+			Env env(app, creator);
+		}
+
+		v8::StartupData blob = creator.CreateBlob(v8::SnapshotCreator::FunctionCodeHandling::kClear);
+		if (blob.data == nullptr)
+		{
+			logger.error("Could not create the startup snapshot!");
+			return false;
+		}
+
+		if (path.has_parent_path())
+			std::filesystem::create_directories(path.parent_path());
+
+		std::ofstream os(path, std::ios::binary | std::ios::trunc);
+		os.write(blob.data, blob.raw_size);
+		delete[] blob.data;
+
+		if (!os)
+		{
+			logger.error("Could not write the startup snapshot to ", path.string());
+			return false;
+		}
+
+		logger.info("Wrote the startup snapshot to ", path.string());
+		return true;
+	}
+
+	Snapshot::Snapshot() :
+		data_(),
+		startupData_({ nullptr, 0 })
+	{ }
+
+	bool Snapshot::load(const std::filesystem::path& path)
+	{
+		std::ifstream is(path, std::ios::binary);
+		if (!is)
+			return false;
+
+		data_.assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+		startupData_ = { data_.data(), static_cast<int>(data_.size()) };
+
+		// V8 aborts on a snapshot of another version, so a stale file is dropped here instead
+		if (data_.empty() || !startupData_.IsValid())
+		{
+			data_.clear();
+			startupData_ = { nullptr, 0 };
+			return false;
+		}
+
+		return true;
+	}
+}
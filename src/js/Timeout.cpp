@@ -9,11 +9,14 @@ namespace NativeJS::JS
 
 	Timeout::Timeout(const Env& env, std::chrono::milliseconds resolveTime, const bool loop) :
 		ObjectWrapper(env),
-		index_(0),
+		id_(0),
+		timer_(),
 		resolveTime_(resolveTime),
 		loop_(loop),
 		isTerminated_(false)
-	{ }
+	{
+		timer_.data = this;
+	}
 
 	Timeout::~Timeout() { }
 
@@ -28,9 +31,14 @@ namespace NativeJS::JS
 		setInternalPointer(env_, value(), this, 0);
 	}
 
-	void Timeout::setIndex(size_t index)
+	void Timeout::setId(size_t id)
+	{
+		id_ = id;
+	}
+
+	void Timeout::terminate()
 	{
-		index_ = index;
+		isTerminated_ = true;
 	}
 
 	JS_METHOD_IMPL(Timeout::resolve);
@@ -53,45 +61,38 @@ namespace NativeJS::JS
 		else
 		{
 			args.This()->Set(env.context(), string(env, Timeout::RESOLVER_KEY), args[0]);
-			size_t index = 0;
-			if (env.addTimeout(args[0].As<v8::Function>(), args[1], args.This(), l >= 3 ? args[2] : v8::Local<v8::Value>(), index));
+			size_t id = 0;
+			if (env.addTimeout(args[0].As<v8::Function>(), args[1], args.This(), l >= 3 ? args[2] : v8::Local<v8::Value>(), id));
 			{
-				args.This()->SetInternalField(1, number(env, index));
+				args.This()->SetInternalField(1, number(env, id));
 			}
 		}
 	}
 
 	JS_CLASS_METHOD_IMPL(TimeoutClass::setTimeoutWrapper)
 	{
-		TimeoutClass* jsClass = static_cast<TimeoutClass*>(args.Data().As<v8::External>()->Value());
-		args.GetReturnValue().Set(jsClass->instantiate({ args[0], args[1], v8::Boolean::New(env.isolate(), false) }).ToLocalChecked());
+		const TimeoutClass& jsClass = env.getJsClasses().timeoutClass;
+		args.GetReturnValue().Set(jsClass.instantiate({ args[0], args[1], v8::Boolean::New(env.isolate(), false) }).ToLocalChecked());
 	}
 
 	JS_CLASS_METHOD_IMPL(TimeoutClass::setIntervalWrapper)
 	{
-		TimeoutClass* jsClass = static_cast<TimeoutClass*>(args.Data().As<v8::External>()->Value());
-		args.GetReturnValue().Set(jsClass->instantiate({ args[0], args[1], v8::Boolean::New(env.isolate(), true) }).ToLocalChecked());
+		const TimeoutClass& jsClass = env.getJsClasses().timeoutClass;
+		args.GetReturnValue().Set(jsClass.instantiate({ args[0], args[1], v8::Boolean::New(env.isolate(), true) }).ToLocalChecked());
 	}
 
 	JS_CLASS_METHOD_IMPL(TimeoutClass::cancel)
 	{
-		JS::Timeout* timeout = getInternalPointer<JS::Timeout>(args, 0);
-		if (timeout->isTerminated())
+		// the native timeout may already be freed, so it is only reached through its generation-tagged id
+		auto internalField = args.This()->GetInternalField(1);
+		size_t id = 0;
+		if (!parseNumber(env.context(), internalField, id))
 		{
-			env.throwException("Timeout is already terminated!");
+			env.throwException("Could not remove timeout!");
 		}
-		else
+		else if (!env.removeTimeout(id))
 		{
-			auto internalField = args.This()->GetInternalField(1);
-			size_t index = 0;
-			if (parseNumber(env.context(), internalField, index))
-			{
-				env.removeTimeout(index);
-			}
-			else
-			{
-				env.throwException("Could not remove timeout!");
-			}
+			env.throwException("Timeout is already terminated!");
 		}
 	}
 
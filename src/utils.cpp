@@ -9,8 +9,12 @@ namespace NativeJS
 		{
 			size_t length = strlen(str) + 1;
 			std::wstring wc(length, L'\0');
+#ifdef _WINDOWS
 			size_t numOfConverted = 0;
 			mbstowcs_s(&numOfConverted, &wc[0], length, str, length);
+#else
+			mbstowcs(&wc[0], str, length);
+#endif
 			return wc;
 		}
 
@@ -3,9 +3,22 @@
 
 declare type ProcessArgs = ReadonlyArray<string>;
 
+interface ArrayBufferStats
+{
+	/** bytes held by the ArrayBuffers of this worker that are still alive */
+	liveBytes: number;
+	peakBytes: number;
+	/** bytes allocated by this worker since it started */
+	totalBytes: number;
+	allocations: number;
+	/** bytes held by the app-wide size-class pools, shared by all workers */
+	pooledBytes: number;
+}
+
 interface Process
 {
 	args: ProcessArgs;
+	arrayBuffers(): ArrayBufferStats;
 }
 
 declare const process: Process;
@@ -22,6 +22,11 @@ declare module "native-js"
 			protected onLoad(e: IEvent): void;
 			protected onClose(e: ICancelableEvent): void;
 			protected onClosed(e: IEvent): void;
+			/** @param samples the positions that were coalesced into this event, oldest first */
+			protected onMouseMove(x: number, y: number, samples: [number, number][]): void;
+			protected onResize(width: number, height: number): void;
+			/** @param delta the accumulated wheel delta of all the coalesced scrolls */
+			protected onScroll(delta: number, samples: [number, number][]): void;
 		}
 	}
 
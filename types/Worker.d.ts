@@ -1,11 +1,33 @@
 /// <reference path="./Event.d.ts" />
+declare interface HeapLimits
+{
+	/** 0 keeps the V8 default */
+	maxOldGenerationMb?: number;
+	maxYoungGenerationMb?: number;
+	codeRangeMb?: number;
+	/**
+	 * What the worker does when its heap gets close to maxOldGenerationMb.
+	 * "collect" runs a full GC, "emit" calls the onHeapLimit listeners of the worker itself and "terminate" stops the worker.
+	 * A worker that keeps growing past the raised limit is always terminated.
+	 */
+	onNearLimit?: "collect" | "emit" | "terminate";
+}
+
+declare interface WorkerOptions
+{
+	/** defaults to the heap settings in app.json */
+	heap?: HeapLimits;
+}
+
 declare class Worker
 {
 	public static getParentWorker(): Worker | null;
 
-	public constructor(entry: string);
+	public constructor(entry: string, options?: WorkerOptions);
 
 	public on(eventType: string, callback: () => any): void;
+	/** called when the heap of the worker gets close to its limit and onNearLimit is "emit", messages never reach it */
+	public onHeapLimit(callback: () => any): void;
 	public send(msg: string): void;
 	public terminate(): Promise<void>;
 }
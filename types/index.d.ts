@@ -12,5 +12,8 @@ declare module "native-js"
 	export default NativeJS;
 }
 
-declare const __dirname: string;
-declare const __filename: string;
\ No newline at end of file
+interface ImportMeta
+{
+	readonly dirname: string;
+	readonly filename: string;
+}
\ No newline at end of file